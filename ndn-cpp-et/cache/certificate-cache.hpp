@@ -11,6 +11,8 @@
 #include <ndn-cpp-dev/name.hpp>
 #include <ndn-cpp-dev/security/certificate.hpp>
 
+#include "../security/decoded-public-key.hpp"
+
 namespace ndn
 {
 
@@ -25,6 +27,15 @@ namespace ndn
 
     virtual ptr_lib::shared_ptr<const Certificate> 
     getCertificate(const Name& certificateNameWithoutVersion) = 0;
+
+    /**
+     * @brief get the public key of a cached certificate, decoded when it was inserted
+     * @returns the key, NULL if the cache does not keep decoded keys, the certificate is not
+     *          cached, or its key is not an RSA key
+     */
+    virtual ptr_lib::shared_ptr<const DecodedPublicKey>
+    getDecodedPublicKey(const Name& certificateNameWithoutVersion)
+    { return ptr_lib::shared_ptr<const DecodedPublicKey>(); }
   };
 
 }//ndn
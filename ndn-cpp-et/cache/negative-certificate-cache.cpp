@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include "negative-certificate-cache.hpp"
+
+#include "logging.h"
+
+
+INIT_LOGGER("NegativeCertificateCache")
+
+using namespace std;
+
+namespace ndn
+{
+
+class NegativeCertificateCache::NegativeCacheEntry
+{
+public:
+  NegativeCacheEntry()
+  {}
+
+  NegativeCacheEntry(const Time& expire, const boost::posix_time::time_duration& ttl, TrackerList::iterator it)
+    : m_expire(expire)
+    , m_ttl(ttl)
+    , m_it(it)
+  {}
+
+  Time m_expire;
+  boost::posix_time::time_duration m_ttl;
+  TrackerList::iterator m_it;
+};
+
+
+NegativeCertificateCache::NegativeCertificateCache(size_t maxSize, int initialTtl, int maxTtl)
+  : m_maxSize(maxSize)
+  , m_initialTtl(boost::posix_time::milliseconds(initialTtl))
+  , m_maxTtl(boost::posix_time::milliseconds(max(initialTtl, maxTtl)))
+  , m_hitCount(0)
+  , m_missCount(0)
+{}
+
+NegativeCertificateCache::~NegativeCertificateCache()
+{}
+
+NegativeCertificateCache::Time
+NegativeCertificateCache::getNow()
+{ return boost::posix_time::microsec_clock::universal_time(); }
+
+bool
+NegativeCertificateCache::find(const Name& keyLocatorName)
+{
+  Time now = getNow();
+
+  // an expired entry is kept for the backoff of the next failure
+  UniqueLock lock(m_mutex);
+  Cache::iterator it = m_cache.find(keyLocatorName);
+  if(it == m_cache.end() || now >= it->second.m_expire)
+    {
+      m_missCount++;
+      return false;
+    }
+
+  m_hitCount++;
+  return true;
+}
+
+void
+NegativeCertificateCache::insert(const Name& keyLocatorName)
+{
+  if(0 == m_maxSize)
+    return;
+
+  Time now = getNow();
+
+  UniqueLock lock(m_mutex);
+  Cache::iterator it = m_cache.find(keyLocatorName);
+  if(it != m_cache.end())
+    {
+      NegativeCacheEntry& entry = it->second;
+      if(now < entry.m_expire + m_maxTtl)
+        entry.m_ttl = min(entry.m_ttl * 2, m_maxTtl);
+      else
+        entry.m_ttl = m_initialTtl;
+      entry.m_expire = now + entry.m_ttl;
+      m_lruList.splice(m_lruList.end(), m_lruList, entry.m_it);
+      _LOG_DEBUG("NegativeCertificateCache: " << keyLocatorName << " rejected for " << entry.m_ttl);
+    }
+  else
+    {
+      while(m_cache.size() >= m_maxSize)
+        {
+          m_cache.erase(m_lruList.front());
+          m_lruList.pop_front();
+        }
+      TrackerList::iterator tracker = m_lruList.insert(m_lruList.end(), keyLocatorName);
+      m_cache[keyLocatorName] = NegativeCacheEntry(now + m_initialTtl, m_initialTtl, tracker);
+    }
+}
+
+void
+NegativeCertificateCache::erase(const Name& keyLocatorName)
+{
+  UniqueLock lock(m_mutex);
+  Cache::iterator it = m_cache.find(keyLocatorName);
+  if(it == m_cache.end())
+    return;
+
+  m_lruList.erase(it->second.m_it);
+  m_cache.erase(it);
+}
+
+size_t
+NegativeCertificateCache::size()
+{
+  UniqueLock lock(m_mutex);
+  return m_cache.size();
+}
+
+uint64_t
+NegativeCertificateCache::getHitCount()
+{
+  UniqueLock lock(m_mutex);
+  return m_hitCount;
+}
+
+uint64_t
+NegativeCertificateCache::getMissCount()
+{
+  UniqueLock lock(m_mutex);
+  return m_missCount;
+}
+
+}//ndn
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_NEGATIVE_CERTIFICATE_CACHE_H
+#define NDN_NEGATIVE_CERTIFICATE_CACHE_H
+
+#include <ndn-cpp-dev/name.hpp>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <list>
+#include <map>
+
+namespace ndn
+{
+
+/**
+ * @brief A bounded LRU cache of the key locators whose certificate recently could not be
+ *        fetched or verified.
+ *
+ * A packet signed by such a key is rejected without fetching the certificate again until
+ * the entry expires.  The first failure is remembered for the initial TTL.  A failure
+ * recorded less than the maximum TTL after the previous entry expired doubles the TTL of the
+ * previous one, up to the maximum TTL.
+ */
+class NegativeCertificateCache
+{
+protected:
+  class NegativeCacheEntry;
+
+  typedef boost::posix_time::ptime Time;
+  typedef std::list<Name> TrackerList;
+  typedef boost::mutex Lock;
+  typedef boost::unique_lock<Lock> UniqueLock;
+  typedef std::map<Name, NegativeCacheEntry> Cache;
+
+public:
+  /**
+   * @param maxSize the maximum number of key locators
+   * @param initialTtl the time a key locator is rejected after its first failure, in milliseconds
+   * @param maxTtl the longest time a key locator is rejected, in milliseconds
+   */
+  NegativeCertificateCache(size_t maxSize = 1000, int initialTtl = 1000, int maxTtl = 60000);
+
+  virtual
+  ~NegativeCertificateCache();
+
+  /**
+   * @brief check if the certificate of a key locator has failed recently
+   * @param keyLocatorName the key locator name of a data packet
+   */
+  bool
+  find(const Name& keyLocatorName);
+
+  /**
+   * @brief record that the certificate of a key locator could not be fetched or verified
+   */
+  void
+  insert(const Name& keyLocatorName);
+
+  /**
+   * @brief forget the failures of a key locator, once its certificate has been verified
+   */
+  void
+  erase(const Name& keyLocatorName);
+
+  size_t
+  size();
+
+  /**
+   * @brief get the number of calls to find() that found an entry that has not expired
+   */
+  uint64_t
+  getHitCount();
+
+  /**
+   * @brief get the number of calls to find() that found no entry, or an expired one
+   */
+  uint64_t
+  getMissCount();
+
+protected:
+  /**
+   * @brief get the current time, overridden to run the cache on another clock
+   */
+  virtual Time
+  getNow();
+
+protected:
+  size_t m_maxSize;
+  boost::posix_time::time_duration m_initialTtl;
+  boost::posix_time::time_duration m_maxTtl;
+  Cache m_cache;
+  TrackerList m_lruList;
+  uint64_t m_hitCount;
+  uint64_t m_missCount;
+  Lock m_mutex;
+};
+
+}//ndn
+
+#endif
@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include "rule-decision-cache.hpp"
+
+#include "logging.h"
+
+
+INIT_LOGGER("RuleDecisionCache")
+
+using namespace std;
+
+namespace ndn
+{
+
+class RuleDecisionCache::RuleDecisionEntry
+{
+public:
+  RuleDecisionEntry()
+  {}
+
+  RuleDecisionEntry(bool isAccepted, uint64_t generation, TrackerList::iterator it)
+    : m_isAccepted(isAccepted)
+    , m_generation(generation)
+    , m_it(it)
+  {}
+
+  bool m_isAccepted;
+  uint64_t m_generation;
+  TrackerList::iterator m_it;
+};
+
+
+RuleDecisionCache::RuleDecisionCache(size_t maxSize, size_t prefixDepth)
+  : m_maxSize(maxSize)
+  , m_prefixDepth(prefixDepth)
+  , m_generation(0)
+{}
+
+RuleDecisionCache::~RuleDecisionCache()
+{}
+
+RuleDecisionCache::Key
+RuleDecisionCache::makeKey(const Name& dataName, const Name& signerName) const
+{
+  if(0 == m_prefixDepth || dataName.size() <= m_prefixDepth)
+    return Key(dataName, signerName);
+  else
+    return Key(dataName.getPrefix(m_prefixDepth), signerName);
+}
+
+bool
+RuleDecisionCache::find(const Name& dataName, const Name& signerName, bool& isAccepted)
+{
+  Key key = makeKey(dataName, signerName);
+
+  UniqueLock lock(m_mutex);
+  Cache::iterator it = m_cache.find(key);
+  if(it == m_cache.end())
+    return false;
+
+  if(it->second.m_generation != m_generation)
+    {
+      m_lruList.erase(it->second.m_it);
+      m_cache.erase(it);
+      return false;
+    }
+
+  m_lruList.splice(m_lruList.end(), m_lruList, it->second.m_it);
+  isAccepted = it->second.m_isAccepted;
+  return true;
+}
+
+void
+RuleDecisionCache::insert(const Name& dataName, const Name& signerName, bool isAccepted, uint64_t generation)
+{
+  if(0 == m_maxSize)
+    return;
+
+  Key key = makeKey(dataName, signerName);
+
+  UniqueLock lock(m_mutex);
+  if(generation != m_generation)
+    return;
+
+  Cache::iterator it = m_cache.find(key);
+  if(it != m_cache.end())
+    {
+      m_lruList.splice(m_lruList.end(), m_lruList, it->second.m_it);
+      it->second.m_isAccepted = isAccepted;
+      it->second.m_generation = m_generation;
+    }
+  else
+    {
+      while(m_cache.size() >= m_maxSize)
+        {
+          m_cache.erase(m_lruList.front());
+          m_lruList.pop_front();
+        }
+      TrackerList::iterator tracker = m_lruList.insert(m_lruList.end(), key);
+      m_cache[key] = RuleDecisionEntry(isAccepted, m_generation, tracker);
+    }
+}
+
+void
+RuleDecisionCache::invalidate()
+{
+  UniqueLock lock(m_mutex);
+  // stale entries are dropped when they are found or pushed out of the LRU list
+  m_generation++;
+  _LOG_DEBUG("rule decisions invalidated, generation " << m_generation);
+}
+
+uint64_t
+RuleDecisionCache::getGeneration()
+{
+  UniqueLock lock(m_mutex);
+  return m_generation;
+}
+
+size_t
+RuleDecisionCache::size()
+{
+  UniqueLock lock(m_mutex);
+  return m_cache.size();
+}
+
+}//ndn
@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_RULE_DECISION_CACHE_H
+#define NDN_RULE_DECISION_CACHE_H
+
+#include <ndn-cpp-dev/name.hpp>
+
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <stdint.h>
+#include <list>
+#include <map>
+
+namespace ndn
+{
+
+/**
+ * @brief A bounded LRU cache of the outcome of the verification rules of a policy, keyed by
+ *        the data name, or a prefix of it, and the key locator name.
+ *
+ * The rules only look at these two names, so packets with the same names get the same
+ * outcome.  When the rules change, invalidate() bumps a generation counter, and entries of
+ * older generations are no longer returned.
+ */
+class RuleDecisionCache
+{
+protected:
+  class RuleDecisionEntry;
+
+  typedef std::pair<Name, Name> Key;
+  typedef std::list<Key> TrackerList;
+  typedef boost::mutex Lock;
+  typedef boost::unique_lock<Lock> UniqueLock;
+  typedef std::map<Key, RuleDecisionEntry> Cache;
+
+public:
+  /**
+   * @param maxSize The maximum number of entries
+   * @param prefixDepth The number of data name components the outcome is keyed by, 0 for
+   *        the whole data name.  A depth is only correct if no rule looks further than it.
+   */
+  RuleDecisionCache(size_t maxSize = 10000, size_t prefixDepth = 0);
+
+  virtual
+  ~RuleDecisionCache();
+
+  /**
+   * @brief look up the outcome of the rules
+   * @param dataName The data name
+   * @param signerName The key locator name
+   * @param isAccepted Receives true if the rules let the data be verified with the key,
+   *        false if they reject it
+   * @returns false if the outcome is not cached
+   */
+  bool
+  find(const Name& dataName, const Name& signerName, bool& isAccepted);
+
+  /**
+   * @brief cache the outcome of the rules
+   * @param generation The generation when the rules were evaluated, see getGeneration();
+   *        the outcome is dropped if the cache has been invalidated since
+   */
+  void
+  insert(const Name& dataName, const Name& signerName, bool isAccepted, uint64_t generation);
+
+  /**
+   * @brief forget all the outcomes, to be called when the rules change
+   */
+  void
+  invalidate();
+
+  uint64_t
+  getGeneration();
+
+  size_t
+  getPrefixDepth() const
+  { return m_prefixDepth; }
+
+  size_t
+  size();
+
+private:
+  Key
+  makeKey(const Name& dataName, const Name& signerName) const;
+
+protected:
+  size_t m_maxSize;
+  size_t m_prefixDepth;
+  uint64_t m_generation;
+  Cache m_cache;
+  TrackerList m_lruList;
+  Lock m_mutex;
+};
+
+}//ndn
+
+#endif
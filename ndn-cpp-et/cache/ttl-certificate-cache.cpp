@@ -27,14 +27,17 @@ public:
   TTLCacheEntry()
   {}
 
-  TTLCacheEntry(const Time& timestamp, ptr_lib::shared_ptr<Certificate> certificate, TrackerList::iterator it)
+  TTLCacheEntry(const Time& timestamp, ptr_lib::shared_ptr<Certificate> certificate,
+                ptr_lib::shared_ptr<const DecodedPublicKey> decodedKey, TrackerList::iterator it)
     : m_timestamp(timestamp)
     , m_certificate(certificate)
+    , m_decodedKey(decodedKey)
     , m_it(it)
   {}
 
   Time m_timestamp;
   ptr_lib::shared_ptr<Certificate> m_certificate;
+  ptr_lib::shared_ptr<const DecodedPublicKey> m_decodedKey;
   TrackerList::iterator m_it;
 };
    
@@ -73,6 +76,10 @@ TTLCertificateCache::insertCertificate(ptr_lib::shared_ptr<Certificate> certific
 {
   Name name = certificate->getName().getPrefix(-1);
   Time expire = posix_time::microsec_clock::universal_time() + posix_time::milliseconds(certificate->getFreshnessPeriod());
+
+  // decoded once here, so that every verification with the certificate can use the key; a
+  // key of another type than RSA is left to Verifier
+  ptr_lib::shared_ptr<const DecodedPublicKey> decodedKey = DecodedPublicKey::decode(certificate->getPublicKeyInfo());
   
   {
     UniqueRecLock lock(m_mutex);
@@ -82,6 +89,7 @@ TTLCertificateCache::insertCertificate(ptr_lib::shared_ptr<Certificate> certific
         m_lruList.splice(m_lruList.end(), m_lruList, it->second.m_it);
         it->second.m_timestamp = expire;
         it->second.m_certificate = certificate;
+        it->second.m_decodedKey = decodedKey;
       }
     else
       {
@@ -91,7 +99,7 @@ TTLCertificateCache::insertCertificate(ptr_lib::shared_ptr<Certificate> certific
             m_lruList.pop_front();
           }
         TrackerList::iterator it = m_lruList.insert(m_lruList.end(), name);
-        m_cache[name] = TTLCacheEntry(expire, certificate, it);
+        m_cache[name] = TTLCacheEntry(expire, certificate, decodedKey, it);
       }
   }
 }
@@ -112,6 +120,17 @@ TTLCertificateCache::getCertificate(const Name & certificateName)
   }
 }
 
+ptr_lib::shared_ptr<const DecodedPublicKey>
+TTLCertificateCache::getDecodedPublicKey(const Name & certificateName)
+{
+  UniqueRecLock lock(m_mutex);
+  Cache::iterator it = m_cache.find(certificateName);
+  if(it != m_cache.end())
+    return it->second.m_decodedKey;
+  else
+    return ptr_lib::shared_ptr<const DecodedPublicKey>();
+}
+
 void
 TTLCertificateCache::cleanLoop()
 {
@@ -49,6 +49,9 @@ public:
   
   virtual ptr_lib::shared_ptr<const Certificate> 
   getCertificate(const Name & certificateNameWithoutVersion);
+
+  virtual ptr_lib::shared_ptr<const DecodedPublicKey>
+  getDecodedPublicKey(const Name & certificateNameWithoutVersion);
   
   void
   printContent();
@@ -0,0 +1,140 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include "verification-result-cache.hpp"
+#include "../security/decoded-public-key.hpp"
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <cryptopp/sha.h>
+
+#include "logging.h"
+
+
+INIT_LOGGER("VerificationResultCache")
+
+using namespace std;
+
+namespace ndn
+{
+
+class VerificationResultCache::VerificationResultEntry
+{
+public:
+  VerificationResultEntry()
+  {}
+
+  VerificationResultEntry(MillisecondsSince1970 notAfter, TrackerList::iterator it)
+    : m_notAfter(notAfter)
+    , m_it(it)
+  {}
+
+  MillisecondsSince1970 m_notAfter;
+  TrackerList::iterator m_it;
+};
+
+
+VerificationResultCache::VerificationResultCache(size_t maxSize)
+  : m_maxSize(maxSize)
+{}
+
+VerificationResultCache::~VerificationResultCache()
+{}
+
+VerificationResultCache::Digest
+VerificationResultCache::computeDigest(const Data& data)
+{
+  return computeDigest(data.wireEncode());
+}
+
+VerificationResultCache::Digest
+VerificationResultCache::computeDigest(const Block& wire)
+{
+  uint8_t digest[CryptoPP::SHA256::DIGESTSIZE];
+  if(!DecodedPublicKey::computeDigest(wire, digest))
+    return Digest();
+
+  return makeDigest(wire, digest);
+}
+
+VerificationResultCache::Digest
+VerificationResultCache::makeDigest(const Block& wire, const uint8_t* signedDigest)
+{
+  const uint8_t* buf = 0;
+  size_t size = 0;
+  const uint8_t* sig = 0;
+  size_t sigSize = 0;
+  if(!DecodedPublicKey::parseSignedWire(wire, buf, size, sig, sigSize))
+    return Digest();
+
+  Digest digest;
+  digest.reserve(CryptoPP::SHA256::DIGESTSIZE + sigSize);
+  digest.append(reinterpret_cast<const char*>(signedDigest), CryptoPP::SHA256::DIGESTSIZE);
+  digest.append(reinterpret_cast<const char*>(sig), sigSize);
+  return digest;
+}
+
+MillisecondsSince1970
+VerificationResultCache::getNow()
+{
+  static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+  return (boost::posix_time::microsec_clock::universal_time() - epoch).total_milliseconds();
+}
+
+bool
+VerificationResultCache::find(const Digest& digest, const Name& certificateName)
+{
+  UniqueLock lock(m_mutex);
+  Cache::iterator it = m_cache.find(Key(digest, certificateName));
+  if(it == m_cache.end())
+    return false;
+
+  if(getNow() > it->second.m_notAfter)
+    {
+      m_lruList.erase(it->second.m_it);
+      m_cache.erase(it);
+      return false;
+    }
+
+  m_lruList.splice(m_lruList.end(), m_lruList, it->second.m_it);
+  return true;
+}
+
+void
+VerificationResultCache::insert(const Digest& digest, const Certificate& certificate)
+{
+  if(0 == m_maxSize || getNow() > certificate.getNotAfter())
+    return;
+
+  Key key(digest, certificate.getName());
+
+  UniqueLock lock(m_mutex);
+  Cache::iterator it = m_cache.find(key);
+  if(it != m_cache.end())
+    {
+      m_lruList.splice(m_lruList.end(), m_lruList, it->second.m_it);
+      it->second.m_notAfter = certificate.getNotAfter();
+    }
+  else
+    {
+      while(m_cache.size() >= m_maxSize)
+        {
+          m_cache.erase(m_lruList.front());
+          m_lruList.pop_front();
+        }
+      TrackerList::iterator tracker = m_lruList.insert(m_lruList.end(), key);
+      m_cache[key] = VerificationResultEntry(certificate.getNotAfter(), tracker);
+    }
+}
+
+size_t
+VerificationResultCache::size()
+{
+  UniqueLock lock(m_mutex);
+  return m_cache.size();
+}
+
+}//ndn
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_VERIFICATION_RESULT_CACHE_H
+#define NDN_VERIFICATION_RESULT_CACHE_H
+
+#include <ndn-cpp-dev/data.hpp>
+#include <ndn-cpp-dev/security/certificate.hpp>
+
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <list>
+#include <map>
+
+namespace ndn
+{
+
+/**
+ * @brief A bounded LRU cache of successful signature verifications.
+ *
+ * An entry is keyed by the SHA-256 digest of the signed portion of a data packet followed
+ * by its signature bits, and by the full name (with version) of the certificate the
+ * signature was verified with.  The digest of the signed portion is also the one the RSA
+ * check needs, so a packet is hashed once whether it is found or verified.  A duplicate
+ * packet is then accepted after one hash and one lookup.  Entries expire when the
+ * certificate does.
+ */
+class VerificationResultCache
+{
+public:
+  /**
+   * @brief The key of a data packet, see computeDigest
+   */
+  typedef std::string Digest;
+
+protected:
+  class VerificationResultEntry;
+
+  typedef std::pair<Digest, Name> Key;
+  typedef std::list<Key> TrackerList;
+  typedef boost::mutex Lock;
+  typedef boost::unique_lock<Lock> UniqueLock;
+  typedef std::map<Key, VerificationResultEntry> Cache;
+
+public:
+  VerificationResultCache(size_t maxSize = 10000);
+
+  virtual
+  ~VerificationResultCache();
+
+  static Digest
+  computeDigest(const Data& data);
+
+  /**
+   * @brief compute the key of a data packet from its wire encoding, read in place
+   * @returns an empty digest if wire has no SignatureValue
+   */
+  static Digest
+  computeDigest(const Block& wire);
+
+  /**
+   * @brief make the key of a data packet from the digest of its signed portion, computed
+   *        beforehand (see DecodedPublicKey::computeDigest), and its signature bits
+   * @param wire The Data TLV, the signature bits are read in place
+   * @param signedDigest The SHA-256 digest of the signed portion
+   * @returns an empty digest if wire has no SignatureValue
+   */
+  static Digest
+  makeDigest(const Block& wire, const uint8_t* signedDigest);
+
+  /**
+   * @brief check if a data packet has been verified with a certificate that has not expired
+   * @param digest The digest of the data packet
+   * @param certificateName The full name of the certificate
+   */
+  bool
+  find(const Digest& digest, const Name& certificateName);
+
+  /**
+   * @brief record that a data packet has been verified with a certificate
+   * @param digest The digest of the data packet
+   * @param certificate The certificate, the entry expires at its notAfter time
+   */
+  void
+  insert(const Digest& digest, const Certificate& certificate);
+
+  size_t
+  size();
+
+protected:
+  static MillisecondsSince1970
+  getNow();
+
+protected:
+  size_t m_maxSize;
+  Cache m_cache;
+  TrackerList m_lruList;
+  Lock m_mutex;
+};
+
+}//ndn
+
+#endif
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include "verified-chain-cache.hpp"
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "logging.h"
+
+
+INIT_LOGGER("VerifiedChainCache")
+
+using namespace std;
+
+namespace ndn
+{
+
+class VerifiedChainCache::VerifiedChainEntry
+{
+public:
+  VerifiedChainEntry()
+  {}
+
+  VerifiedChainEntry(const Link& link, TrackerList::iterator it)
+    : m_link(link)
+    , m_it(it)
+  {}
+
+  Link m_link;
+  TrackerList::iterator m_it;
+};
+
+
+VerifiedChainCache::VerifiedChainCache(size_t maxSize)
+  : m_maxSize(maxSize)
+{}
+
+VerifiedChainCache::~VerifiedChainCache()
+{}
+
+MillisecondsSince1970
+VerifiedChainCache::getNow()
+{
+  static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+  return (boost::posix_time::microsec_clock::universal_time() - epoch).total_milliseconds();
+}
+
+bool
+VerifiedChainCache::find(const Name& keyName, Link& link)
+{
+  UniqueLock lock(m_mutex);
+  Cache::iterator it = m_cache.find(keyName);
+  if(it == m_cache.end())
+    return false;
+
+  if(getNow() >= it->second.m_link.m_expire)
+    {
+      m_lruList.erase(it->second.m_it);
+      m_cache.erase(it);
+      return false;
+    }
+
+  m_lruList.splice(m_lruList.end(), m_lruList, it->second.m_it);
+  link = it->second.m_link;
+  return true;
+}
+
+MillisecondsSince1970
+VerifiedChainCache::insert(ptr_lib::shared_ptr<const Certificate> certificate,
+                           ptr_lib::shared_ptr<const DecodedPublicKey> decodedKey,
+                           const Name& anchorName,
+                           MillisecondsSince1970 issuerExpire)
+{
+  MillisecondsSince1970 now = getNow();
+
+  Link link;
+  link.m_certificate = certificate;
+  link.m_decodedKey = decodedKey;
+  link.m_anchorName = anchorName;
+  link.m_expire = min(issuerExpire, certificate->getNotAfter());
+  // a negative freshness period is not set
+  if(certificate->getFreshnessPeriod() >= 0)
+    link.m_expire = min(link.m_expire, now + static_cast<MillisecondsSince1970>(certificate->getFreshnessPeriod()));
+
+  if(0 == m_maxSize || now >= link.m_expire)
+    return link.m_expire;
+
+  Name keyName = certificate->getName().getPrefix(-1);
+
+  UniqueLock lock(m_mutex);
+  Cache::iterator it = m_cache.find(keyName);
+  if(it != m_cache.end())
+    {
+      m_lruList.splice(m_lruList.end(), m_lruList, it->second.m_it);
+      it->second.m_link = link;
+    }
+  else
+    {
+      while(m_cache.size() >= m_maxSize)
+        {
+          m_cache.erase(m_lruList.front());
+          m_lruList.pop_front();
+        }
+      TrackerList::iterator tracker = m_lruList.insert(m_lruList.end(), keyName);
+      m_cache[keyName] = VerifiedChainEntry(link, tracker);
+    }
+
+  _LOG_DEBUG("VerifiedChainCache: " << keyName << " verified up to " << anchorName);
+  return link.m_expire;
+}
+
+size_t
+VerifiedChainCache::size()
+{
+  UniqueLock lock(m_mutex);
+  return m_cache.size();
+}
+
+size_t
+VerifiedChainCache::getMaxSize() const
+{
+  return m_maxSize;
+}
+
+}//ndn
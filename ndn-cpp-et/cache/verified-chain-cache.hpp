@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_VERIFIED_CHAIN_CACHE_H
+#define NDN_VERIFIED_CHAIN_CACHE_H
+
+#include <ndn-cpp-dev/security/certificate.hpp>
+
+#include "../security/decoded-public-key.hpp"
+
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <list>
+#include <map>
+
+namespace ndn
+{
+
+/**
+ * @brief A bounded LRU cache of the certificates verified up to a trust anchor.
+ *
+ * A certificate is recorded with the trust anchor its chain leads to, and expires at the
+ * earliest notAfter or freshness time of the certificates in the chain, so that it is not
+ * used once any certificate between it and the anchor has expired.  A packet signed by a
+ * certificate in the cache is verified without any further chain step.
+ */
+class VerifiedChainCache
+{
+public:
+  /**
+   * @brief A certificate with the chain it has been verified through
+   */
+  struct Link
+  {
+    ptr_lib::shared_ptr<const Certificate> m_certificate;
+    ptr_lib::shared_ptr<const DecodedPublicKey> m_decodedKey;
+    Name m_anchorName;
+    MillisecondsSince1970 m_expire;
+  };
+
+protected:
+  class VerifiedChainEntry;
+
+  typedef std::list<Name> TrackerList;
+  typedef boost::mutex Lock;
+  typedef boost::unique_lock<Lock> UniqueLock;
+  typedef std::map<Name, VerifiedChainEntry> Cache;
+
+public:
+  VerifiedChainCache(size_t maxSize = 1000);
+
+  virtual
+  ~VerifiedChainCache();
+
+  /**
+   * @brief find a certificate whose chain has not expired
+   * @param keyName The certificate name without version, as in a key locator
+   * @param link Set to the certificate and its chain if it is found
+   */
+  bool
+  find(const Name& keyName, Link& link);
+
+  /**
+   * @brief record a certificate verified with the certificate of its issuer
+   * @param certificate The certificate
+   * @param decodedKey The decoded key of the certificate, NULL if it is not decoded
+   * @param anchorName The name of the trust anchor the chain of the issuer leads to
+   * @param issuerExpire The expiry of the chain of the issuer, the notAfter time of the
+   *        anchor if the issuer is the anchor
+   * @return the expiry of the chain of the certificate, not recorded if it is not later than now
+   */
+  MillisecondsSince1970
+  insert(ptr_lib::shared_ptr<const Certificate> certificate,
+         ptr_lib::shared_ptr<const DecodedPublicKey> decodedKey,
+         const Name& anchorName,
+         MillisecondsSince1970 issuerExpire);
+
+  size_t
+  size();
+
+  /**
+   * @brief get the largest number of certificates recorded, 0 if insert records none
+   */
+  size_t
+  getMaxSize() const;
+
+  /**
+   * @brief get the current time the chains expire against, overridden to run the cache on
+   *        another clock
+   */
+  virtual MillisecondsSince1970
+  getNow();
+
+protected:
+  size_t m_maxSize;
+  Cache m_cache;
+  TrackerList m_lruList;
+  Lock m_mutex;
+};
+
+}//ndn
+
+#endif
@@ -10,8 +10,11 @@
 #include <ndn-cpp-dev/security/verifier.hpp>
 #include <ndn-cpp-dev/security/signature-sha256-with-rsa.hpp>
 #include "../cache/ttl-certificate-cache.hpp"
+#include "../security/multi-buffer-sha256.hpp"
 
 #include <boost/bind.hpp>
+#include <sstream>
+#include <string.h>
 
 #include "logging.h"
 
@@ -26,86 +29,804 @@ using namespace std;
 
 namespace ndn
 {
+  // the largest number of learned issuers, and of prefetched certificates waiting for their step
+  static const size_t MAX_PREDICTIONS = 1000;
+
+  class SecPolicySimple::SpeculativeDigest
+  {
+  public:
+    SpeculativeDigest()
+      : m_isReady(false)
+    {}
+
+    void
+    compute(Block wire)
+    {
+      uint8_t digest[CryptoPP::SHA256::DIGESTSIZE];
+      if(DecodedPublicKey::computeDigest(wire, digest))
+        set(digest);
+    }
+
+    void
+    set(const uint8_t* digest)
+    {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      memcpy(m_digest, digest, sizeof(m_digest));
+      m_isReady = true;
+    }
+
+    bool
+    get(uint8_t* digest)
+    {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      if(m_isReady)
+        memcpy(digest, m_digest, sizeof(m_digest));
+      return m_isReady;
+    }
+
+  private:
+    boost::mutex m_mutex;
+    bool m_isReady;
+    uint8_t m_digest[CryptoPP::SHA256::DIGESTSIZE];
+  };
+
+  class SecPolicySimple::CallbackGuard
+  {
+  public:
+    CallbackGuard(SecPolicySimple* policy)
+      : m_policy(policy)
+    {}
+
+    void
+    onPrefetchData(const ptr_lib::shared_ptr<const Interest>& interest, const ptr_lib::shared_ptr<Data>& data)
+    {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      if(0 != m_policy)
+        m_policy->onPrefetchData(interest, data);
+    }
+
+    void
+    onPrefetchTimeout(const ptr_lib::shared_ptr<const Interest>& interest)
+    {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      if(0 != m_policy)
+        m_policy->onPrefetchTimeout(interest);
+    }
+
+    void
+    onFetchDeadline(const Name& keyLocatorName, ptr_lib::shared_ptr<boost::asio::deadline_timer> deadline,
+                    const boost::system::error_code& error)
+    {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      if(0 != m_policy && !error)
+        m_policy->expireFetch(keyLocatorName, deadline);
+    }
+
+    // waits for a callback in progress, the callbacks after it are dropped
+    void
+    release()
+    {
+      boost::lock_guard<boost::mutex> lock(m_mutex);
+      m_policy = 0;
+    }
+
+  private:
+    boost::mutex m_mutex;
+    SecPolicySimple* m_policy;
+  };
+
   const ptr_lib::shared_ptr<CertificateCache>  SecPolicySimple::DEFAULT_CERTIFICATE_CACHE_PTR = ptr_lib::shared_ptr<CertificateCache>();
 
+  const int SecPolicySimple::DEFAULT_FETCH_DEADLINE;
+
   SecPolicySimple::SecPolicySimple(const int stepLimit,
                                    ptr_lib::shared_ptr<CertificateCache> certificateCache)
     : m_stepLimit(stepLimit)
+    , m_regexDegreeLimit(0)
     , m_certificateCache(certificateCache)
+    , m_fetchDeadline(boost::posix_time::milliseconds(DEFAULT_FETCH_DEADLINE))
+    , m_callbackGuard(ptr_lib::make_shared<CallbackGuard>(this))
+    , m_poolTaskCount(0)
   {
-    if(static_cast<bool>(m_certificateCache))
+    if(!static_cast<bool>(m_certificateCache))
       m_certificateCache = ptr_lib::make_shared<TTLCertificateCache>();
   }
 
+  SecPolicySimple::~SecPolicySimple()
+  {
+    // the face and the io_service may outlive the policy, the callbacks of the Interests and
+    // the deadlines still pending are dropped
+    m_callbackGuard->release();
+    map<Name, PendingFetch>::const_iterator fetch = m_pendingFetches.begin();
+    for(; fetch != m_pendingFetches.end(); fetch++)
+      {
+        if(static_cast<bool>(fetch->second.m_deadline))
+          fetch->second.m_deadline->cancel();
+      }
+
+    if(static_cast<bool>(m_prefetchFace))
+      {
+        map<Name, const PendingInterestId*>::const_iterator it = m_prefetching.begin();
+        for(; it != m_prefetching.end(); it++)
+          {
+            if(0 != it->second)
+              m_prefetchFace->removePendingInterest(it->second);
+          }
+      }
+
+    // the pool tasks hold this policy, the pool may outlive it
+    boost::unique_lock<boost::mutex> lock(m_poolTaskMutex);
+    while(0 != m_poolTaskCount)
+      m_poolTaskFinished.wait(lock);
+  }
+
+  void
+  SecPolicySimple::checkComplexity(const RegexComplexity& complexity, const string& expr)
+  {
+    if(0 >= m_regexDegreeLimit)
+      return;
+
+    if(complexity.isExponential())
+      {
+        string problems;
+        vector<string>::const_iterator it = complexity.getProblems().begin();
+        for(; it != complexity.getProblems().end(); it++)
+          problems += "; " + *it;
+        throw Error("Regex " + expr + " has exponential matching cost" + problems);
+      }
+
+    if(complexity.getDegree() > m_regexDegreeLimit)
+      {
+        ostringstream os;
+        os << "Regex " << expr << " has matching cost O(n^" << complexity.getDegree()
+           << "), above the limit O(n^" << m_regexDegreeLimit << ")";
+        throw Error(os.str());
+      }
+  }
+
   bool
   SecPolicySimple::requireVerify (const Data& data)
   {
+    VerificationContext context(data);
+
     RuleList::iterator it = m_verifyPolicies.begin();
     for(; it != m_verifyPolicies.end(); it++)
       {
-	if((*it)->matchDataName(data))
+	if((*it)->matchDataName(context))
 	  return true;
       }
 
     it = m_mustFailVerify.begin();
     for(; it != m_mustFailVerify.end(); it++)
       {
-	if((*it)->matchDataName(data))
+	if((*it)->matchDataName(context))
 	  return true;
       }
 
+    RegexList::iterator exempt = m_digestExempt.begin();
+    for(; exempt != m_digestExempt.end(); exempt++)
+      {
+        if((*exempt)->match(context.getDataView()))
+          return true;
+      }
+
     return false;
   }
 
   bool 
   SecPolicySimple::skipVerifyAndTrust (const Data& data)
   {
+    // The Name of data is already decoded and its components are read in place.  Reaching
+    // the Name TLV in the wire would take a walk through the Data TLV, or encoding the Name.
+    RegexNameView dataView(data.getName());
+    m_dataMemo.reset(dataView.size());
+    dataView.setMemo(&m_dataMemo);
+
     RegexList::iterator it = m_verifyExempt.begin();
     for(; it != m_verifyExempt.end(); it++)
       {
-	if((*it)->match(data.getName()))
+	if((*it)->match(dataView))
 	  return true;
       }
 
     return false;
   }
 
+  ptr_lib::shared_ptr<IdentityCertificate>
+  SecPolicySimple::acceptCertificate(const ptr_lib::shared_ptr<Data>& signCertificate,
+                                     ptr_lib::shared_ptr<const DecodedPublicKey>& decodedKey)
+  {
+    // The copy shares the encoding and the blocks of the received packet, which must then be
+    // encoded already; a packet that is an IdentityCertificate is not copied at all.
+    ptr_lib::shared_ptr<IdentityCertificate> certificate = ptr_lib::dynamic_pointer_cast<IdentityCertificate>(signCertificate);
+    if(!static_cast<bool>(certificate))
+      {
+        signCertificate->wireEncode();
+        certificate = ptr_lib::make_shared<IdentityCertificate>(*signCertificate);
+      }
+
+    if(certificate->isTooLate() || certificate->isTooEarly())
+      return ptr_lib::shared_ptr<IdentityCertificate>();
+
+    if(static_cast<bool>(m_prefetchFace))
+      learnIssuer(*certificate);
+
+    if(!static_cast<bool>(m_verifiedChainCache))
+      return cacheCertificate(certificate, decodedKey);
+
+    // the certificate has just been verified with the certificate of its issuer
+    VerificationContext context(*certificate);
+    if(!context.hasSignerName())
+      return ptr_lib::shared_ptr<IdentityCertificate>();
+
+    Name anchorName;
+    MillisecondsSince1970 issuerExpire;
+    map<Name, ptr_lib::shared_ptr<IdentityCertificate> >::const_iterator anchor = m_trustAnchors.find(context.getSignerName());
+    VerifiedChainCache::Link issuer;
+    if(m_trustAnchors.end() != anchor)
+      {
+        anchorName = anchor->first;
+        issuerExpire = anchor->second->getNotAfter();
+      }
+    else if(m_verifiedChainCache->find(context.getSignerName(), issuer))
+      {
+        anchorName = issuer.m_anchorName;
+        issuerExpire = issuer.m_expire;
+      }
+    else
+      {
+        // the chain of the issuer has been evicted, has expired with its freshness or was
+        // never recorded, the issuer itself has just been verified
+        _LOG_DEBUG("chain of " << context.getSignerName() << " is not cached");
+        return cacheCertificate(certificate, decodedKey);
+      }
+
+    MillisecondsSince1970 now = m_verifiedChainCache->getNow();
+    if(issuerExpire <= now)
+      return ptr_lib::shared_ptr<IdentityCertificate>();
+
+    decodedKey = DecodedPublicKey::decode(certificate->getPublicKeyInfo());
+
+    if(0 == m_verifiedChainCache->getMaxSize()
+       || m_verifiedChainCache->insert(certificate, decodedKey, anchorName, issuerExpire) <= now)
+      return cacheCertificate(certificate, decodedKey);
+
+    return certificate;
+  }
+
+  ptr_lib::shared_ptr<IdentityCertificate>
+  SecPolicySimple::cacheCertificate(const ptr_lib::shared_ptr<IdentityCertificate>& certificate,
+                                    ptr_lib::shared_ptr<const DecodedPublicKey>& decodedKey)
+  {
+    m_certificateCache->insertCertificate(certificate);
+    decodedKey = m_certificateCache->getDecodedPublicKey(certificate->getName().getPrefix(-1));
+    return certificate;
+  }
+
+  ptr_lib::shared_ptr<ValidationRequest>
+  SecPolicySimple::waitForCertificate(const Name& keyLocatorName, const CertificateWaiter& waiter, int stepCount)
+  {
+    // a fetch past its deadline whose timer has not run, or that has no timer
+    expireFetch(keyLocatorName, ptr_lib::shared_ptr<boost::asio::deadline_timer>());
+
+    if(static_cast<bool>(m_negativeCertificateCache) && m_negativeCertificateCache->find(keyLocatorName))
+      {
+        _LOG_DEBUG("certificate of " << keyLocatorName << " failed recently");
+        waiter.m_onVerifyFailed(waiter.m_data);
+        return ptr_lib::shared_ptr<ValidationRequest>();
+      }
+
+    // the signed portion is hashed while the certificate is fetched, only the public-key
+    // operation is left for when it arrives
+    CertificateWaiter speculativeWaiter(waiter);
+    if(static_cast<bool>(m_verificationPool) && !static_cast<bool>(speculativeWaiter.m_digest))
+      {
+        speculativeWaiter.m_digest = ptr_lib::make_shared<SpeculativeDigest>();
+        m_verificationPool->submit(func_lib::bind(&SpeculativeDigest::compute, speculativeWaiter.m_digest,
+                                                  speculativeWaiter.m_wire));
+      }
+
+    ptr_lib::shared_ptr<Data> prefetched;
+    {
+      boost::lock_guard<boost::mutex> lock(m_pendingMutex);
+      map<Name, PendingFetch>::iterator it = m_pendingFetches.find(keyLocatorName);
+      if(m_pendingFetches.end() != it)
+        {
+          it->second.m_waiters.push_back(speculativeWaiter);
+          return ptr_lib::shared_ptr<ValidationRequest>();
+        }
+
+      PendingFetch& fetch = m_pendingFetches[keyLocatorName];
+      fetch.m_expire = boost::posix_time::microsec_clock::universal_time() + m_fetchDeadline;
+      if(static_cast<bool>(m_fetchIoService))
+        {
+          fetch.m_deadline.reset(new boost::asio::deadline_timer(*m_fetchIoService, m_fetchDeadline));
+          fetch.m_deadline->async_wait(func_lib::bind(&CallbackGuard::onFetchDeadline, m_callbackGuard,
+                                                      keyLocatorName, fetch.m_deadline, _1));
+        }
+
+      map<Name, ptr_lib::shared_ptr<Data> >::iterator prefetchedIt = m_prefetched.find(keyLocatorName);
+      if(m_prefetched.end() != prefetchedIt)
+        {
+          prefetched = prefetchedIt->second;
+          m_prefetched.erase(prefetchedIt);
+        }
+    }
+
+    // the Verifier fails this waiter itself if the Interest times out
+    ptr_lib::shared_ptr<WaiterList> requestWaiter = ptr_lib::make_shared<WaiterList>(1, speculativeWaiter);
+
+    OnVerified recursiveVerifiedCallback = func_lib::bind(&SecPolicySimple::onPendingCertificateVerified,
+                                                          this,
+                                                          _1,
+                                                          keyLocatorName,
+                                                          requestWaiter);
+
+    OnVerifyFailed recursiveUnverifiedCallback = func_lib::bind(&SecPolicySimple::onPendingCertificateUnverified,
+                                                                this,
+                                                                _1,
+                                                                keyLocatorName,
+                                                                requestWaiter);
+
+    // the step the Verifier would take once the certificate arrives, taken now
+    if(static_cast<bool>(prefetched))
+      return checkVerificationPolicy(prefetched, stepCount + 1, recursiveVerifiedCallback, recursiveUnverifiedCallback);
+
+    if(static_cast<bool>(m_prefetchFace))
+      prefetchChain(keyLocatorName);
+
+    ptr_lib::shared_ptr<Interest> interest = ptr_lib::make_shared<Interest>(boost::cref(keyLocatorName));
+
+    return ptr_lib::make_shared<ValidationRequest>(interest,
+                                                   recursiveVerifiedCallback,
+                                                   recursiveUnverifiedCallback,
+                                                   3,
+                                                   stepCount + 1);
+  }
+
   void
-  SecPolicySimple::onCertificateVerified(ptr_lib::shared_ptr<Data>signCertificate, 
-					     ptr_lib::shared_ptr<Data>data, 
-					     const OnVerified& onVerified, 
-					     const OnVerifyFailed& onVerifyFailed)
+  SecPolicySimple::learnIssuer(const IdentityCertificate& certificate)
   {
-    ptr_lib::shared_ptr<IdentityCertificate> certificate = ptr_lib::make_shared<IdentityCertificate>(*signCertificate);
+    VerificationContext context(certificate);
+    if(!context.hasSignerName())
+      return;
 
-    if(!certificate->isTooLate() && !certificate->isTooEarly())
+    PredictedIssuer issuer;
+    issuer.m_certificateName = certificate.getName();
+    issuer.m_issuerName = context.getSignerName();
+
+    Name keyName = certificate.getName().getPrefix(-1);
+    boost::lock_guard<boost::mutex> lock(m_pendingMutex);
+    if(m_predictedIssuers.size() >= MAX_PREDICTIONS && m_predictedIssuers.end() == m_predictedIssuers.find(keyName))
+      m_predictedIssuers.erase(m_predictedIssuers.begin());
+    m_predictedIssuers[keyName] = issuer;
+  }
+
+  vector<Name>
+  SecPolicySimple::predictChain(const Name& keyLocatorName)
+  {
+    vector<PredictedIssuer> links;
+    {
+      boost::lock_guard<boost::mutex> lock(m_pendingMutex);
+      Name keyName = keyLocatorName;
+      for(int depth = 0; depth < m_stepLimit; depth++)
+        {
+          map<Name, PredictedIssuer>::const_iterator it = m_predictedIssuers.find(keyName);
+          if(m_predictedIssuers.end() == it)
+            break;
+          links.push_back(it->second);
+          keyName = it->second.m_issuerName;
+        }
+    }
+
+    vector<Name> chain;
+    vector<PredictedIssuer>::const_iterator it = links.begin();
+    for(; it != links.end(); it++)
       {
-        m_certificateCache->insertCertificate(certificate);
+        if(!matchVerificationRules(it->m_certificateName, it->m_issuerName))
+          break;
 
-        try{
-          if(Verifier::verifySignature(*data, data->getSignature(), certificate->getPublicKeyInfo()))
-            {
-              onVerified(data);
-              return;
-            }
-        }catch(Signature::Error &e){
-          _LOG_DEBUG("SecPolicySimple Error: " << e.what());
-          onVerifyFailed(data);
-          return;
+        ptr_lib::shared_ptr<const DecodedPublicKey> decodedKey;
+        if(static_cast<bool>(findCertificate(it->m_issuerName, decodedKey)))
+          break;
+
+        chain.push_back(it->m_issuerName);
+      }
+    return chain;
+  }
+
+  void
+  SecPolicySimple::prefetchChain(const Name& keyLocatorName)
+  {
+    vector<Name> chain = predictChain(keyLocatorName);
+
+    vector<Name> names;
+    {
+      boost::lock_guard<boost::mutex> lock(m_pendingMutex);
+      vector<Name>::const_iterator it = chain.begin();
+      for(; it != chain.end(); it++)
+        {
+          if(m_prefetched.end() != m_prefetched.find(*it)
+             || !m_prefetching.insert(make_pair(*it, static_cast<const PendingInterestId*>(0))).second)
+            continue;
+          names.push_back(*it);
         }
+    }
+
+    vector<Name>::const_iterator it = names.begin();
+    for(; it != names.end(); it++)
+      {
+        _LOG_DEBUG("prefetch " << *it);
+        const PendingInterestId* interestId =
+          expressPrefetchInterest(*it,
+                                  func_lib::bind(&CallbackGuard::onPrefetchData, m_callbackGuard, _1, _2),
+                                  func_lib::bind(&CallbackGuard::onPrefetchTimeout, m_callbackGuard, _1));
+
+        // the Interest may have been answered already
+        boost::lock_guard<boost::mutex> lock(m_pendingMutex);
+        map<Name, const PendingInterestId*>::iterator pending = m_prefetching.find(*it);
+        if(m_prefetching.end() != pending)
+          pending->second = interestId;
+      }
+  }
+
+  const PendingInterestId*
+  SecPolicySimple::expressPrefetchInterest(const Name& name, const OnData& onData, const OnTimeout& onTimeout)
+  {
+    return m_prefetchFace->expressInterest(name, onData, onTimeout);
+  }
+
+  void
+  SecPolicySimple::onPrefetchData(const ptr_lib::shared_ptr<const Interest>& interest, const ptr_lib::shared_ptr<Data>& data)
+  {
+    // kept until its chain step, where it is verified like a certificate the Verifier fetched
+    boost::lock_guard<boost::mutex> lock(m_pendingMutex);
+    m_prefetching.erase(interest->getName());
+    if(m_prefetched.size() >= MAX_PREDICTIONS)
+      m_prefetched.erase(m_prefetched.begin());
+    m_prefetched[interest->getName()] = data;
+  }
+
+  void
+  SecPolicySimple::onPrefetchTimeout(const ptr_lib::shared_ptr<const Interest>& interest)
+  {
+    boost::lock_guard<boost::mutex> lock(m_pendingMutex);
+    m_prefetching.erase(interest->getName());
+  }
+
+  SecPolicySimple::WaiterList
+  SecPolicySimple::takeWaiters(const Name& keyLocatorName, WaiterList& requestWaiter)
+  {
+    WaiterList waiters;
+
+    boost::lock_guard<boost::mutex> lock(m_pendingMutex);
+    waiters.swap(requestWaiter);
+    map<Name, PendingFetch>::iterator it = m_pendingFetches.find(keyLocatorName);
+    if(m_pendingFetches.end() != it)
+      {
+        waiters.insert(waiters.end(), it->second.m_waiters.begin(), it->second.m_waiters.end());
+        if(static_cast<bool>(it->second.m_deadline))
+          it->second.m_deadline->cancel();
+        m_pendingFetches.erase(it);
+      }
+    return waiters;
+  }
+
+  void
+  SecPolicySimple::expireFetch(const Name& keyLocatorName, ptr_lib::shared_ptr<boost::asio::deadline_timer> deadline)
+  {
+    WaiterList waiters;
+    {
+      boost::lock_guard<boost::mutex> lock(m_pendingMutex);
+      map<Name, PendingFetch>::iterator it = m_pendingFetches.find(keyLocatorName);
+      if(m_pendingFetches.end() == it)
+        return;
+      if(static_cast<bool>(deadline) ? it->second.m_deadline != deadline
+                                     : boost::posix_time::microsec_clock::universal_time() < it->second.m_expire)
+        return;
+
+      if(static_cast<bool>(it->second.m_deadline))
+        it->second.m_deadline->cancel();
+      waiters.swap(it->second.m_waiters);
+      m_pendingFetches.erase(it);
+    }
+
+    // the certificate could not be fetched in time, the next packets signed by the key are
+    // rejected without fetching it again
+    _LOG_DEBUG("fetch of " << keyLocatorName << " expired with " << waiters.size() << " waiters");
+    if(static_cast<bool>(m_negativeCertificateCache))
+      m_negativeCertificateCache->insert(keyLocatorName);
+
+    for(WaiterList::iterator it = waiters.begin(); it != waiters.end(); it++)
+      it->m_onVerifyFailed(it->m_data);
+  }
+
+  void
+  SecPolicySimple::onPendingCertificateVerified(ptr_lib::shared_ptr<Data> signCertificate, const Name& keyLocatorName,
+                                               ptr_lib::shared_ptr<WaiterList> requestWaiter)
+  {
+    // recorded before the waiters are taken, so that a later packet finds the outcome instead
+    // of fetching the certificate again
+    ptr_lib::shared_ptr<const DecodedPublicKey> decodedKey;
+    ptr_lib::shared_ptr<IdentityCertificate> certificate = acceptCertificate(signCertificate, decodedKey);
+    if(static_cast<bool>(m_negativeCertificateCache))
+      {
+        if(static_cast<bool>(certificate))
+          m_negativeCertificateCache->erase(keyLocatorName);
+        else
+          m_negativeCertificateCache->insert(keyLocatorName);
+      }
+
+    WaiterList waiters = takeWaiters(keyLocatorName, *requestWaiter);
+    if(!static_cast<bool>(certificate))
+      {
+        for(WaiterList::iterator it = waiters.begin(); it != waiters.end(); it++)
+          it->m_onVerifyFailed(it->m_data);
+        return;
+      }
+
+    // the waiters not hashed on the verification pool are hashed together
+    if(static_cast<bool>(decodedKey))
+      digestSignedPortions(waiters);
+
+    for(WaiterList::iterator it = waiters.begin(); it != waiters.end(); it++)
+      verifyWithCertificate(*it, certificate, decodedKey);
+  }
+
+  void
+  SecPolicySimple::onPendingCertificateUnverified(ptr_lib::shared_ptr<Data> signCertificate, const Name& keyLocatorName,
+                                                 ptr_lib::shared_ptr<WaiterList> requestWaiter)
+  {
+    if(static_cast<bool>(m_negativeCertificateCache))
+      m_negativeCertificateCache->insert(keyLocatorName);
+
+    WaiterList waiters = takeWaiters(keyLocatorName, *requestWaiter);
+    for(WaiterList::iterator it = waiters.begin(); it != waiters.end(); it++)
+      it->m_onVerifyFailed(it->m_data);
+  }
+
+  bool
+  SecPolicySimple::verifyWithoutCertificate(const VerificationContext& context)
+  {
+    switch(context.getSignatureType()){
+    case Signature::Sha256:
+      {
+        bool isExempted = false;
+        RegexList::iterator it = m_digestExempt.begin();
+        for(; it != m_digestExempt.end() && !isExempted; it++)
+          isExempted = (*it)->match(context.getDataView());
+        if(!isExempted)
+          {
+            _LOG_DEBUG("DigestSha256 is not accepted for " << context.getData().getName());
+            return false;
+          }
+
+        const uint8_t* buf = 0;
+        size_t size = 0;
+        const uint8_t* sig = 0;
+        size_t sigSize = 0;
+        if(!DecodedPublicKey::parseSignedWire(context.getData().wireEncode(), buf, size, sig, sigSize)
+           || CryptoPP::SHA256::DIGESTSIZE != sigSize)
+          return false;
+
+        uint8_t digest[CryptoPP::SHA256::DIGESTSIZE];
+        CryptoPP::SHA256().CalculateDigest(digest, buf, size);
+        return 0 == memcmp(digest, sig, sigSize);
+      }
+    default:
+      _LOG_DEBUG("signature type " << context.getSignatureType() << " of " << context.getData().getName()
+                 << " is not supported");
+      return false;
+    }
+  }
+
+  bool
+  SecPolicySimple::matchVerificationRules(const VerificationContext& context)
+  {
+    RuleList::iterator it = m_mustFailVerify.begin();
+    for(; it != m_mustFailVerify.end(); it++)
+      {
+	if((*it)->satisfy(context))
+          return false;
+      }
+
+    it = m_verifyPolicies.begin();
+    for(; it != m_verifyPolicies.end(); it++)
+      {
+	if((*it)->satisfy(context))
+          return true;
+      }
+
+    return false;
+  }
+
+  bool
+  SecPolicySimple::checkVerificationRules(const VerificationContext& context)
+  {
+    if(!static_cast<bool>(m_ruleDecisionCache))
+      return matchVerificationRules(context);
+
+    bool isAccepted = false;
+    if(!m_ruleDecisionCache->find(context.getData().getName(), context.getSignerName(), isAccepted))
+      {
+        uint64_t generation = m_ruleDecisionCache->getGeneration();
+        isAccepted = matchVerificationRules(context);
+        m_ruleDecisionCache->insert(context.getData().getName(), context.getSignerName(), isAccepted, generation);
+      }
+    return isAccepted;
+  }
+
+  ptr_lib::shared_ptr<const Certificate>
+  SecPolicySimple::findCertificate(const Name& keyLocatorName, ptr_lib::shared_ptr<const DecodedPublicKey>& decodedKey)
+  {
+    map<Name, ptr_lib::shared_ptr<IdentityCertificate> >::const_iterator anchor = m_trustAnchors.find(keyLocatorName);
+    if(m_trustAnchors.end() == anchor)
+      {
+        VerifiedChainCache::Link link;
+        if(static_cast<bool>(m_verifiedChainCache) && m_verifiedChainCache->find(keyLocatorName, link))
+          {
+            decodedKey = link.m_decodedKey;
+            return link.m_certificate;
+          }
+
+        decodedKey = m_certificateCache->getDecodedPublicKey(keyLocatorName);
+        return m_certificateCache->getCertificate(keyLocatorName);
+      }
+
+    map<Name, ptr_lib::shared_ptr<const DecodedPublicKey> >::const_iterator key = m_trustAnchorKeys.find(keyLocatorName);
+    decodedKey = (m_trustAnchorKeys.end() == key ? ptr_lib::shared_ptr<const DecodedPublicKey>() : key->second);
+    return anchor->second;
+  }
+
+  bool
+  SecPolicySimple::matchVerificationRules(const Name& dataName, const Name& signerName)
+  {
+    RegexNameView dataView(dataName);
+    m_dataMemo.reset(dataView.size());
+    dataView.setMemo(&m_dataMemo);
+    RegexNameView signerView(signerName);
+    m_signerMemo.reset(signerView.size());
+    signerView.setMemo(&m_signerMemo);
+
+    RuleList::iterator it = m_mustFailVerify.begin();
+    for(; it != m_mustFailVerify.end(); it++)
+      {
+	if((*it)->satisfy(dataView, signerView))
+          return false;
+      }
+
+    it = m_verifyPolicies.begin();
+    for(; it != m_verifyPolicies.end(); it++)
+      {
+	if((*it)->satisfy(dataView, signerView))
+          return true;
       }
+
+    return false;
+  }
+
+  bool
+  SecPolicySimple::verifySignature(const Data& data, const Block& wire, const Certificate& certificate,
+                                   ptr_lib::shared_ptr<const DecodedPublicKey> decodedKey,
+                                   const uint8_t* signedDigest)
+  {
+    // a key decoded for another signature type is left to Verifier
+    const Signature& signature = data.getSignature();
+    bool isDecoded = (static_cast<bool>(decodedKey) && decodedKey->canVerify(signature.getType()));
+
+    // one hash of the signed portion keys the result cache and feeds the RSA check
+    uint8_t digest[CryptoPP::SHA256::DIGESTSIZE];
+    if(0 == signedDigest && (isDecoded || static_cast<bool>(m_verificationResultCache)))
+      {
+        if(!DecodedPublicKey::computeDigest(wire, digest))
+          return false;
+        signedDigest = digest;
+      }
+
+    VerificationResultCache::Digest resultKey;
+    if(static_cast<bool>(m_verificationResultCache))
+      {
+        resultKey = VerificationResultCache::makeDigest(wire, signedDigest);
+        if(m_verificationResultCache->find(resultKey, certificate.getName()))
+          return true;
+      }
+
+    bool isVerified = false;
+    if(isDecoded)
+      isVerified = decodedKey->verifyDigest(wire, signature, signedDigest);
     else
+      isVerified = Verifier::verifySignature(data, signature, certificate.getPublicKeyInfo());
+    if(!isVerified)
+      return false;
+
+    if(!static_cast<bool>(m_verificationResultCache))
+      return true;
+
+    m_verificationResultCache->insert(resultKey, certificate);
+    return true;
+  }
+
+  void
+  SecPolicySimple::verifyWithCertificate(const CertificateWaiter& waiter,
+                                         ptr_lib::shared_ptr<const Certificate> certificate,
+                                         ptr_lib::shared_ptr<const DecodedPublicKey> decodedKey)
+  {
+    if(!static_cast<bool>(m_verificationPool))
       {
-        onVerifyFailed(data);
+        verifyAndNotify(waiter, certificate, decodedKey, ptr_lib::shared_ptr<boost::asio::io_service>());
         return;
       }
+
+    {
+      boost::lock_guard<boost::mutex> lock(m_poolTaskMutex);
+      m_poolTaskCount++;
+    }
+
+    // the worker reads the wire captured by the waiter, it does not encode the packet
+    if(!m_verificationPool->submit(func_lib::bind(&SecPolicySimple::verifyOnPool, this,
+                                                  waiter, certificate, decodedKey, m_ioService)))
+      {
+        finishPoolTask();
+        verifyAndNotify(waiter, certificate, decodedKey, m_ioService);
+      }
   }
 
   void
-  SecPolicySimple::onCertificateUnverified(ptr_lib::shared_ptr<Data>signCertificate, 
-					       ptr_lib::shared_ptr<Data>data, 
-					       const OnVerifyFailed& onVerifyFailed)
-  { onVerifyFailed(data); }
+  SecPolicySimple::verifyOnPool(CertificateWaiter waiter,
+                                ptr_lib::shared_ptr<const Certificate> certificate,
+                                ptr_lib::shared_ptr<const DecodedPublicKey> decodedKey,
+                                ptr_lib::shared_ptr<boost::asio::io_service> ioService)
+  {
+    try{
+      verifyAndNotify(waiter, certificate, decodedKey, ioService);
+    }catch(...){
+      finishPoolTask();
+      throw;
+    }
+    finishPoolTask();
+  }
+
+  void
+  SecPolicySimple::finishPoolTask()
+  {
+    boost::lock_guard<boost::mutex> lock(m_poolTaskMutex);
+    if(0 == --m_poolTaskCount)
+      m_poolTaskFinished.notify_all();
+  }
+
+  void
+  SecPolicySimple::verifyAndNotify(CertificateWaiter waiter,
+                                   ptr_lib::shared_ptr<const Certificate> certificate,
+                                   ptr_lib::shared_ptr<const DecodedPublicKey> decodedKey,
+                                   ptr_lib::shared_ptr<boost::asio::io_service> ioService)
+  {
+    // the speculative digest is used if it is ready, it is not waited for
+    uint8_t signedDigest[CryptoPP::SHA256::DIGESTSIZE];
+    bool hasDigest = static_cast<bool>(waiter.m_digest) && waiter.m_digest->get(signedDigest);
+
+    bool isVerified = false;
+    try{
+      isVerified = verifySignature(*waiter.m_data, waiter.m_wire, *certificate, decodedKey,
+                                   hasDigest ? signedDigest : 0);
+    }catch(Signature::Error &e){
+      _LOG_DEBUG("SecPolicySimple Error: " << e.what());
+    }
+
+    if(!static_cast<bool>(ioService))
+      {
+        if(isVerified)
+          waiter.m_onVerified(waiter.m_data);
+        else
+          waiter.m_onVerifyFailed(waiter.m_data);
+      }
+    else
+      {
+        if(isVerified)
+          ioService->post(func_lib::bind(waiter.m_onVerified, waiter.m_data));
+        else
+          ioService->post(func_lib::bind(waiter.m_onVerifyFailed, waiter.m_data));
+      }
+  }
 
   ptr_lib::shared_ptr<ValidationRequest>
   SecPolicySimple::checkVerificationPolicy(const ptr_lib::shared_ptr<Data>& data, 
@@ -119,95 +840,176 @@ namespace ndn
       return ptr_lib::shared_ptr<ValidationRequest>();
     }
 
-    RuleList::iterator it = m_mustFailVerify.begin();
-    for(; it != m_mustFailVerify.end(); it++)
+    // the signature is parsed once, every rule is checked against the same context
+    VerificationContext context(*data);
+
+    // SHA256withRSA is verified with the certificate of the signer, the other types here
+    if(Signature::Sha256WithRsa != context.getSignatureType())
       {
-	if((*it)->satisfy(*data))
-          {
-            onVerifyFailed(data);
-            return ptr_lib::shared_ptr<ValidationRequest>();
-          }
+        if(verifyWithoutCertificate(context))
+          onVerified(data);
+        else
+          onVerifyFailed(data);
+        return ptr_lib::shared_ptr<ValidationRequest>();
       }
 
-    it = m_verifyPolicies.begin();
-    for(; it != m_verifyPolicies.end(); it++)
+    // a data packet without signer name satisfies no rule
+    if(!context.hasSignerName())
+      {
+        onVerifyFailed(data);
+        return ptr_lib::shared_ptr<ValidationRequest>();
+      }
+
+    if(!checkVerificationRules(context))
+      {
+        onVerifyFailed(data);
+        return ptr_lib::shared_ptr<ValidationRequest>();
+      }
+
+    const Name& keyLocatorName = context.getSignerName();
+    ptr_lib::shared_ptr<const DecodedPublicKey> decodedKey;
+    ptr_lib::shared_ptr<const Certificate> trustedCert = findCertificate(keyLocatorName, decodedKey);
+
+    if(static_cast<bool>(trustedCert))
+      {
+        verifyWithCertificate(CertificateWaiter(data, onVerified, onVerifyFailed), trustedCert, decodedKey);
+        return ptr_lib::shared_ptr<ValidationRequest>();
+      }
+
+    // the packets signed by a key whose certificate is being fetched wait for that fetch
+    return waitForCertificate(keyLocatorName, CertificateWaiter(data, onVerified, onVerifyFailed), stepCount);
+  }
+
+  void
+  SecPolicySimple::digestSignedPortions(WaiterList& waiters)
+  {
+    vector<CertificateWaiter*> hashed;
+    vector<const uint8_t*> buffers;
+    vector<size_t> sizes;
+    for(WaiterList::iterator it = waiters.begin(); it != waiters.end(); it++)
+      {
+        if(static_cast<bool>(it->m_digest) || Signature::Sha256WithRsa != it->m_data->getSignature().getType())
+          continue;
+
+        const uint8_t* buf = 0;
+        size_t size = 0;
+        const uint8_t* sig = 0;
+        size_t sigSize = 0;
+        if(!DecodedPublicKey::parseSignedWire(it->m_wire, buf, size, sig, sigSize))
+          continue;
+
+        hashed.push_back(&*it);
+        buffers.push_back(buf);
+        sizes.push_back(size);
+      }
+
+    if(hashed.empty())
+      return;
+
+    vector<uint8_t> digests(hashed.size() * MultiBufferSha256::DIGEST_SIZE);
+    MultiBufferSha256::digest(&buffers[0], &sizes[0], hashed.size(), &digests[0]);
+    for(size_t i = 0; i < hashed.size(); i++)
       {
-	if((*it)->satisfy(*data))
+        hashed[i]->m_digest = ptr_lib::make_shared<SpeculativeDigest>();
+        hashed[i]->m_digest->set(&digests[i * MultiBufferSha256::DIGEST_SIZE]);
+      }
+  }
+
+  vector<ptr_lib::shared_ptr<ValidationRequest> >
+  SecPolicySimple::verifyBatch(const vector<ptr_lib::shared_ptr<Data> >& dataList,
+                               const OnVerified& onVerified,
+                               const OnVerifyFailed& onVerifyFailed)
+  {
+    vector<ptr_lib::shared_ptr<ValidationRequest> > requests;
+    if(0 == m_stepLimit)
+      {
+        _LOG_DEBUG("reach the maximum steps of verification");
+        for(size_t i = 0; i < dataList.size(); i++)
+          onVerifyFailed(dataList[i]);
+        return requests;
+      }
+
+    // the contexts refer to the packets of dataList, a group lists their positions by key locator
+    typedef map<Name, vector<size_t> > GroupMap;
+    vector<ptr_lib::shared_ptr<VerificationContext> > contexts(dataList.size());
+    GroupMap groups;
+    for(size_t i = 0; i < dataList.size(); i++)
+      {
+        contexts[i] = ptr_lib::make_shared<VerificationContext>(*dataList[i]);
+        if(contexts[i]->hasSignerName())
+          groups[contexts[i]->getSignerName()].push_back(i);
+        else if(Signature::Sha256WithRsa != contexts[i]->getSignatureType() && verifyWithoutCertificate(*contexts[i]))
+          onVerified(dataList[i]);
+        else
+          onVerifyFailed(dataList[i]);
+      }
+
+    GroupMap::const_iterator group = groups.begin();
+    for(; group != groups.end(); group++)
+      {
+        const vector<size_t>& positions = group->second;
+        const VerificationContext& signerContext = *contexts[positions[0]];
+
+        WaiterList accepted;
+        for(size_t i = 0; i < positions.size(); i++)
           {
-            try{
-              SignatureSha256WithRsa sig(data->getSignature());                
-              
-              Name keyLocatorName = sig.getKeyLocator().getName();
-              ptr_lib::shared_ptr<const Certificate> trustedCert;
-              if(m_trustAnchors.end() == m_trustAnchors.find(keyLocatorName))
-                trustedCert = m_certificateCache->getCertificate(keyLocatorName);
-              else
-                trustedCert = m_trustAnchors[keyLocatorName];
-
-              if(static_cast<bool>(trustedCert)){
-                if(Verifier::verifySignature(*data, sig, trustedCert->getPublicKeyInfo()))
-                  onVerified(data);
-                else
-                  onVerifyFailed(data);
-                onVerifyFailed(data);
-
-                return ptr_lib::shared_ptr<ValidationRequest>();
-              }
-              else{
-                // _LOG_DEBUG("KeyLocator is not trust anchor");                
-                OnVerified recursiveVerifiedCallback = func_lib::bind(&SecPolicySimple::onCertificateVerified, 
-                                                                      this, 
-                                                                      _1, 
-                                                                      data, 
-                                                                      onVerified, 
-                                                                      onVerifyFailed);
-
-                OnVerifyFailed recursiveUnverifiedCallback = func_lib::bind(&SecPolicySimple::onCertificateUnverified, 
-                                                                            this, 
-                                                                            _1, 
-                                                                            data, 
-                                                                            onVerifyFailed);
-
-
-                ptr_lib::shared_ptr<Interest> interest = ptr_lib::make_shared<Interest>(boost::cref(sig.getKeyLocator().getName()));
-
-                ptr_lib::shared_ptr<ValidationRequest> nextStep = ptr_lib::make_shared<ValidationRequest>(interest, 
-                                                                                                          recursiveVerifiedCallback,
-                                                                                                          recursiveUnverifiedCallback,
-                                                                                                          3,
-                                                                                                          stepCount + 1);
-                return nextStep;
-              }
-            }catch(SignatureSha256WithRsa::Error &e){
-              _LOG_DEBUG("SecPolicySimple Error: " << e.what());
-              onVerifyFailed(data);
-              return ptr_lib::shared_ptr<ValidationRequest>(); 
-            }catch(KeyLocator::Error &e){
-              _LOG_DEBUG("SecPolicySimple Error: " << e.what());
-              onVerifyFailed(data);
-              return ptr_lib::shared_ptr<ValidationRequest>(); 
-            }
+            VerificationContext& context = *contexts[positions[i]];
+            context.shareSignerView(signerContext);
+            if(checkVerificationRules(context))
+              accepted.push_back(CertificateWaiter(dataList[positions[i]], onVerified, onVerifyFailed));
+            else
+              onVerifyFailed(dataList[positions[i]]);
+          }
+
+        if(accepted.empty())
+          continue;
+
+        ptr_lib::shared_ptr<const DecodedPublicKey> decodedKey;
+        ptr_lib::shared_ptr<const Certificate> trustedCert = findCertificate(group->first, decodedKey);
+        if(static_cast<bool>(trustedCert))
+          {
+            // the signed portions of the group are hashed together, only the public-key
+            // operation is left per packet
+            if(static_cast<bool>(decodedKey))
+              digestSignedPortions(accepted);
+            for(WaiterList::const_iterator it = accepted.begin(); it != accepted.end(); it++)
+              verifyWithCertificate(*it, trustedCert, decodedKey);
+            continue;
+          }
+
+        WaiterList::const_iterator it = accepted.begin();
+        for(; it != accepted.end(); it++)
+          {
+            ptr_lib::shared_ptr<ValidationRequest> request = waitForCertificate(group->first, *it, 0);
+            if(static_cast<bool>(request))
+              requests.push_back(request);
           }
       }
-    
-    onVerifyFailed(data);
-    return ptr_lib::shared_ptr<ValidationRequest>();
+
+    return requests;
   }
 
   bool 
   SecPolicySimple::checkSigningPolicy(const Name & dataName, const Name & certName)
   {
+    RegexNameView dataView(dataName);
+    m_dataMemo.reset(dataView.size());
+    dataView.setMemo(&m_dataMemo);
+    RegexNameView certView(certName);
+    m_signerMemo.reset(certView.size());
+    certView.setMemo(&m_signerMemo);
+
     RuleList::iterator it = m_mustFailSign.begin();
     for(; it != m_mustFailSign.end(); it++)
       {
-	if((*it)->satisfy(dataName, certName))
+	if((*it)->satisfy(dataView, certView))
 	  return false;
       }
 
     it = m_signPolicies.begin();
     for(; it != m_signPolicies.end(); it++)
       {
-	if((*it)->satisfy(dataName, certName))
+	if((*it)->satisfy(dataView, certView))
 	  return true;
       }
 
@@ -217,10 +1019,14 @@ namespace ndn
   Name
   SecPolicySimple::inferSigningIdentity(const Name & dataName)
   {
+    RegexNameView dataView(dataName);
+    m_dataMemo.reset(dataView.size());
+    dataView.setMemo(&m_dataMemo);
+
     RegexList::iterator it = m_signInference.begin();
     for(; it != m_signInference.end(); it++)
       {
-	if((*it)->match(dataName))
+	if((*it)->match(dataView))
 	  return (*it)->expand();
       }
 
@@ -10,11 +10,24 @@
 
 #include <ndn-cpp-dev/security/sec-policy.hpp>
 #include <ndn-cpp-dev/security/identity-certificate.hpp>
+#include <ndn-cpp-dev/face.hpp>
 
 #include <map>
 #include "sec-rule-relative.hpp"
 #include "../regex/regex.hpp"
+#include "../regex/regex-match-memo.hpp"
 #include "../cache/certificate-cache.hpp"
+#include "../cache/rule-decision-cache.hpp"
+#include "../cache/verification-result-cache.hpp"
+#include "../cache/negative-certificate-cache.hpp"
+#include "../cache/verified-chain-cache.hpp"
+#include "../util/work-stealing-pool.hpp"
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 
 
 namespace ndn {
@@ -28,13 +41,20 @@ public:
   typedef std::vector< ptr_lib::shared_ptr<Regex> > RegexList;
   
   static const ptr_lib::shared_ptr<CertificateCache> DEFAULT_CERTIFICATE_CACHE_PTR;
+
+  // in milliseconds, longer than the Verifier takes to give up on a certificate Interest
+  static const int DEFAULT_FETCH_DEADLINE = 20000;
   
 public:
   SecPolicySimple(const int stepLimit = 10,
                   ptr_lib::shared_ptr<CertificateCache> certificateCache = DEFAULT_CERTIFICATE_CACHE_PTR);
   
+  /**
+   * @brief remove the pending prefetch Interests and fetch deadlines, and wait for the
+   *        verifications queued to the verification pool
+   */
   virtual 
-  ~SecPolicySimple() {}
+  ~SecPolicySimple();
   
   /**
    * @brief check if the received data packet can escape from verification
@@ -54,6 +74,11 @@ public:
   
   /**
    * @brief check whether received data packet complies with the verification policy, and get the indication of next verification step
+   *
+   * Packets signed by a key whose certificate is being fetched wait for that fetch instead
+   * of fetching it again, they are all verified when the certificate arrives.
+   * The signature type selects the verification: SHA256withRSA with the certificate of the
+   * signer, DigestSha256 without certificate under a digest exemption, any other type fails.
    * @param data the received data packet
    * @param stepCount the number of verification steps that have been done, used to track the verification progress
    * @param verifiedCallback the callback function that will be called if the received data packet has been validated
@@ -67,6 +92,24 @@ public:
                           const OnVerifyFailed& onVerifyFailed);
   
     
+  /**
+   * @brief verify a burst of data packets, such as a window of segments from one producer
+   *
+   * The packets are grouped by key locator.  The certificate of a group is found and its key
+   * decoded once, the signer name is matched once for the rules of the group, and the
+   * signatures of the group are then checked one after the other.  OnVerified or
+   * OnVerifyFailed is called for every packet.
+   * @param dataList the received data packets
+   * @param onVerified the callback called for every packet that has been validated
+   * @param onVerifyFailed the callback called for every packet that cannot be validated
+   * @return one request per group whose certificate is neither known nor being fetched, the
+   *         packets of the group are verified when the certificate is verified
+   */
+  std::vector<ptr_lib::shared_ptr<ValidationRequest> >
+  verifyBatch(const std::vector<ptr_lib::shared_ptr<Data> >& dataList,
+              const OnVerified& onVerified,
+              const OnVerifyFailed& onVerifyFailed);
+
   /**
    * @brief check if the signing certificate name and data name satify the signing policy 
    * @param dataName the name of data to be signed
@@ -111,7 +154,107 @@ public:
    */
   inline virtual void
   addVerificationExemption(ptr_lib::shared_ptr<Regex> exempt);
+
+  /**
+   * @brief accept the data packets signed with DigestSha256 whose name matches, without
+   *        certificate, if the signature value is the digest of the signed portion; for flows
+   *        that need integrity only
+   * @param exempt the exemption rule
+   */
+  inline virtual void
+  addDigestExemption(ptr_lib::shared_ptr<Regex> exempt);
   
+  /**
+   * @brief reject expensive regexes when rules, inferences and exemptions are added
+   * @param maxDegree a regex is rejected if its worst-case cost is exponential or above
+   *        O(n^maxDegree) for a name of n components, see RegexComplexity; 0 accepts all regexes
+   */
+  inline void
+  setRegexDegreeLimit(int maxDegree);
+
+  /**
+   * @brief cache the outcome of the verification rules for a data name and a key locator name,
+   *        so that repeated names skip the rules; adding a verification rule invalidates it
+   * @param cache the cache, NULL to evaluate the rules for every packet (the default)
+   */
+  inline void
+  setRuleDecisionCache(ptr_lib::shared_ptr<RuleDecisionCache> cache);
+
+  /**
+   * @brief remember the data packets whose signature has been verified, so that duplicates
+   *        are accepted without verifying the signature again
+   * @param cache the cache, NULL to verify every packet (the default)
+   */
+  inline void
+  setVerificationResultCache(ptr_lib::shared_ptr<VerificationResultCache> cache);
+
+  /**
+   * @brief remember the key locators whose certificate could not be fetched or verified, so
+   *        that their packets are rejected without fetching the certificate again
+   * @param cache the cache, NULL to fetch the certificate for every such packet (the default)
+   */
+  inline void
+  setNegativeCertificateCache(ptr_lib::shared_ptr<NegativeCertificateCache> cache);
+
+  /**
+   * @brief remember the certificates verified up to a trust anchor, each until the earliest
+   *        expiry in its chain; the certificate cache then keeps only the certificates whose
+   *        chain the cache does not know
+   * @param cache the cache, NULL to use the certificate cache (the default)
+   */
+  inline void
+  setVerifiedChainCache(ptr_lib::shared_ptr<VerifiedChainCache> cache);
+
+  /**
+   * @brief fetch the predicted ancestors of a certificate together with the certificate
+   *
+   * The policy learns the issuer of every certificate it verifies.  When the certificate of a
+   * key locator has to be fetched again, the issuers up to a trust anchor are predicted from
+   * what was learned, each link being kept only while the verification rules still accept it,
+   * and their certificates are fetched concurrently through face.  A chain step then finds
+   * its certificate already received instead of fetching it; a step reached before its
+   * certificate arrives fetches it as usual, and the forwarder aggregates the two Interests.
+   * @param face the face the Verifier fetches certificates with, NULL to disable prefetch
+   */
+  inline void
+  setPrefetchFace(ptr_lib::shared_ptr<Face> face);
+
+  /**
+   * @brief get the key locator names of the predicted ancestors of a key locator, nearest
+   *        first, up to a trust anchor or a certificate that is already known
+   */
+  std::vector<Name>
+  predictChain(const Name& keyLocatorName);
+
+  /**
+   * @brief verify signatures on a worker pool instead of the calling thread
+   *
+   * checkVerificationPolicy and the certificate callbacks return once the signature check
+   * is queued, OnVerified or OnVerifyFailed is then posted to ioService.  The policy waits
+   * in its destructor for the verifications it has queued, and a verification that a pool
+   * already shut down drops is run on the calling thread.  The setting must not change
+   * while verifications are in progress.
+   * @param pool the workers, NULL to verify on the calling thread (the default)
+   * @param ioService the io_service the callbacks are posted to
+   */
+  inline void
+  setVerificationPool(ptr_lib::shared_ptr<WorkStealingPool> pool,
+                      ptr_lib::shared_ptr<boost::asio::io_service> ioService);
+
+  /**
+   * @brief fail the packets waiting for a certificate fetch that is not done by a deadline
+   *
+   * The packet whose fetch issued the request is failed by the Verifier when the Interest
+   * times out, the packets that joined the fetch later fail at the deadline.  Without
+   * io_service, the deadline is checked when the next packet signed by the key comes.
+   * @param ioService the io_service the deadlines run on, typically the one of the face of
+   *        the Verifier; NULL to check them only when packets come (the default)
+   * @param milliseconds the deadline, counted from the request
+   */
+  inline void
+  setFetchDeadline(ptr_lib::shared_ptr<boost::asio::io_service> ioService,
+                   int milliseconds = DEFAULT_FETCH_DEADLINE);
+
   /**
    * @brief add a trust anchor
    * @param certificate the trust anchor 
@@ -120,48 +263,373 @@ public:
   addTrustAnchor(ptr_lib::shared_ptr<IdentityCertificate> certificate);
 
 protected:
+  /**
+   * @brief throw Error if a regex exceeds the limit set by setRegexDegreeLimit
+   */
+  void
+  checkComplexity(const RegexComplexity& complexity, const std::string& expr);
+
+  /**
+   * @brief check if no must-fail rule and at least one verification rule is satisfied
+   */
+  bool
+  matchVerificationRules(const VerificationContext& context);
+
+  /**
+   * @brief matchVerificationRules through the rule decision cache, if there is one
+   */
+  bool
+  checkVerificationRules(const VerificationContext& context);
+
+  /**
+   * @brief verify a packet whose signature type is not verified with a certificate, that is
+   *        a DigestSha256 packet covered by a digest exemption; other types fail
+   */
+  bool
+  verifyWithoutCertificate(const VerificationContext& context);
+
+  /**
+   * @brief check if no must-fail rule and at least one verification rule is satisfied by a
+   *        data name and a signer name
+   */
+  bool
+  matchVerificationRules(const Name& dataName, const Name& signerName);
+
+  /**
+   * @brief find the certificate of a key locator among the trust anchors, in the verified
+   *        chain cache if there is one, then in the certificate cache
+   * @param decodedKey set to the decoded key of the certificate, NULL if it is not decoded
+   * @return the certificate, NULL if it must be fetched
+   */
+  ptr_lib::shared_ptr<const Certificate>
+  findCertificate(const Name& keyLocatorName, ptr_lib::shared_ptr<const DecodedPublicKey>& decodedKey);
+
+  /**
+   * @brief the SHA-256 digest of the signed portion of a packet, computed on the verification
+   *        pool while the certificate is fetched, or together with other packets
+   */
+  class SpeculativeDigest;
+
+  /**
+   * @brief a data packet waiting for the certificate of its key locator, or for its
+   *        verification
+   */
+  struct CertificateWaiter
+  {
+    CertificateWaiter(const ptr_lib::shared_ptr<Data>& data,
+                      const OnVerified& onVerified,
+                      const OnVerifyFailed& onVerifyFailed)
+      : m_data(data)
+      , m_wire(data->wireEncode())
+      , m_onVerified(onVerified)
+      , m_onVerifyFailed(onVerifyFailed)
+    {}
+
+    ptr_lib::shared_ptr<Data> m_data;
+    // the encoding the packet arrived with, shares its buffer; the signature is verified on
+    // it in place, even if m_data is changed and encoded again meanwhile
+    Block m_wire;
+    OnVerified m_onVerified;
+    OnVerifyFailed m_onVerifyFailed;
+    ptr_lib::shared_ptr<SpeculativeDigest> m_digest;
+  };
+
+  typedef std::vector<CertificateWaiter> WaiterList;
+
+  /**
+   * @brief hash the signed portions of the waiters without digest with MultiBufferSha256,
+   *        a waiter not signed with SHA256withRSA is left without digest
+   */
+  void
+  digestSignedPortions(WaiterList& waiters);
+
+  /**
+   * @brief verify the signature of data with a certificate, or find the result in the
+   *        verification result cache
+   * @param wire the wire encoding of data, read in place
+   * @param decodedKey the decoded public key of the certificate, NULL to decode it
+   * @param signedDigest the digest of the signed portion if it has been computed, NULL to
+   *        hash the signed portion; it keys the verification result cache and is verified
+   *        with decodedKey
+   */
+  bool
+  verifySignature(const Data& data, const Block& wire, const Certificate& certificate,
+                  ptr_lib::shared_ptr<const DecodedPublicKey> decodedKey,
+                  const uint8_t* signedDigest = 0);
+
+  /**
+   * @brief verify the signature of a waiter with a certificate and call its onVerified or
+   *        onVerifyFailed, on the verification pool if there is one
+   */
+  void
+  verifyWithCertificate(const CertificateWaiter& waiter,
+                        ptr_lib::shared_ptr<const Certificate> certificate,
+                        ptr_lib::shared_ptr<const DecodedPublicKey> decodedKey);
+
+  /**
+   * @brief the part of verifyWithCertificate run on a worker, or directly if ioService is NULL
+   */
+  void
+  verifyAndNotify(CertificateWaiter waiter,
+                  ptr_lib::shared_ptr<const Certificate> certificate,
+                  ptr_lib::shared_ptr<const DecodedPublicKey> decodedKey,
+                  ptr_lib::shared_ptr<boost::asio::io_service> ioService);
+
+  /**
+   * @brief the task queued to the verification pool, verifyAndNotify counted in
+   *        m_poolTaskCount
+   */
+  void
+  verifyOnPool(CertificateWaiter waiter,
+               ptr_lib::shared_ptr<const Certificate> certificate,
+               ptr_lib::shared_ptr<const DecodedPublicKey> decodedKey,
+               ptr_lib::shared_ptr<boost::asio::io_service> ioService);
+
+  void
+  finishPoolTask();
+
+  /**
+   * @brief add a waiter to the fetch of the certificate of keyLocatorName, or reject it if
+   *        the certificate has failed recently
+   *
+   * The waiter that issues the request is kept by the callbacks of the request, not by the
+   * fetch, so that the fetch deadline does not fail it as well as the Verifier.
+   * @return the request to fetch the certificate, NULL if a fetch is already in progress or
+   *         the waiter has been rejected
+   */
+  ptr_lib::shared_ptr<ValidationRequest>
+  waitForCertificate(const Name& keyLocatorName, const CertificateWaiter& waiter, int stepCount);
+
+  /**
+   * @brief remove the fetch of the certificate of keyLocatorName and get its waiters, after
+   *        the waiter of the request
+   * @param requestWaiter the waiter of the request, emptied so that it is taken once
+   */
+  WaiterList
+  takeWaiters(const Name& keyLocatorName, WaiterList& requestWaiter);
+
+  /**
+   * @brief fail the waiters of a fetch whose deadline has passed, and record the key locator
+   *        in the negative certificate cache if there is one
+   * @param deadline the timer of the fetch, nothing is done if the fetch has been replaced;
+   *        NULL to expire the fetch only if it is past its deadline
+   */
+  void
+  expireFetch(const Name& keyLocatorName, ptr_lib::shared_ptr<boost::asio::deadline_timer> deadline);
+
+  /**
+   * @brief cache a verified certificate, in the verified chain cache with the chain of its
+   *        issuer if that chain is found there, otherwise in the certificate cache
+   * @param decodedKey set to the decoded key of the certificate, NULL if it is not decoded
+   * @return the certificate, NULL if it or the trust anchor of its chain is not valid now
+   */
+  ptr_lib::shared_ptr<IdentityCertificate>
+  acceptCertificate(const ptr_lib::shared_ptr<Data>& signCertificate,
+                    ptr_lib::shared_ptr<const DecodedPublicKey>& decodedKey);
+
+  /**
+   * @brief insert a verified certificate into the certificate cache
+   * @param decodedKey set to the decoded key of the certificate, NULL if it is not decoded
+   * @return the certificate
+   */
+  ptr_lib::shared_ptr<IdentityCertificate>
+  cacheCertificate(const ptr_lib::shared_ptr<IdentityCertificate>& certificate,
+                   ptr_lib::shared_ptr<const DecodedPublicKey>& decodedKey);
+
+  /**
+   * @brief verify every waiter of a fetch once the certificate has been verified
+   */
   virtual void
-  onCertificateVerified(ptr_lib::shared_ptr<Data> certificate, 
-                        ptr_lib::shared_ptr<Data> data, 
-                        const OnVerified& onVerified, 
-                        const OnVerifyFailed& onVerifyFailed);
-  
+  onPendingCertificateVerified(ptr_lib::shared_ptr<Data> signCertificate, const Name& keyLocatorName,
+                               ptr_lib::shared_ptr<WaiterList> requestWaiter);
+
   virtual void
-  onCertificateUnverified(ptr_lib::shared_ptr<Data>signCertificate, 
-                          ptr_lib::shared_ptr<Data>data, 
-                          const OnVerifyFailed& onVerifyFailed);
-  
+  onPendingCertificateUnverified(ptr_lib::shared_ptr<Data> signCertificate, const Name& keyLocatorName,
+                                 ptr_lib::shared_ptr<WaiterList> requestWaiter);
+
+  /**
+   * @brief record the issuer of a verified certificate for predictChain
+   */
+  void
+  learnIssuer(const IdentityCertificate& certificate);
+
+  void
+  prefetchChain(const Name& keyLocatorName);
+
+  /**
+   * @brief express the Interest of a prefetch through the prefetch face
+   * @return the id the Interest is removed with if it is still pending when the policy is
+   *         destroyed, NULL if there is none
+   */
+  virtual const PendingInterestId*
+  expressPrefetchInterest(const Name& name, const OnData& onData, const OnTimeout& onTimeout);
+
+  /**
+   * @brief the callbacks of the prefetch Interests and of the fetch deadlines, which reach the
+   *        policy only while it exists
+   */
+  class CallbackGuard;
+
+  void
+  onPrefetchData(const ptr_lib::shared_ptr<const Interest>& interest, const ptr_lib::shared_ptr<Data>& data);
+
+  void
+  onPrefetchTimeout(const ptr_lib::shared_ptr<const Interest>& interest);
+
 protected:
   int m_stepLimit;
+  int m_regexDegreeLimit;
   ptr_lib::shared_ptr<CertificateCache> m_certificateCache;
   RuleList m_mustFailVerify;
   RuleList m_verifyPolicies;
   RegexList m_verifyExempt;
+  RegexList m_digestExempt;
   RuleList m_signPolicies;
   RuleList m_mustFailSign;
   RegexList m_signInference;
   std::map<Name, ptr_lib::shared_ptr<IdentityCertificate> > m_trustAnchors;
+  std::map<Name, ptr_lib::shared_ptr<const DecodedPublicKey> > m_trustAnchorKeys;
+  // reset for every rule check on names, which like the rules must not run concurrently
+  RegexMatchMemo m_dataMemo;
+  RegexMatchMemo m_signerMemo;
+  ptr_lib::shared_ptr<RuleDecisionCache> m_ruleDecisionCache;
+  ptr_lib::shared_ptr<VerificationResultCache> m_verificationResultCache;
+  ptr_lib::shared_ptr<NegativeCertificateCache> m_negativeCertificateCache;
+  ptr_lib::shared_ptr<VerifiedChainCache> m_verifiedChainCache;
+  ptr_lib::shared_ptr<WorkStealingPool> m_verificationPool;
+  ptr_lib::shared_ptr<boost::asio::io_service> m_ioService;
+
+  // the certificates being fetched, by key locator name, with the packets that joined the fetch
+  struct PendingFetch
+  {
+    WaiterList m_waiters;
+    boost::posix_time::ptime m_expire;
+    ptr_lib::shared_ptr<boost::asio::deadline_timer> m_deadline;
+  };
+  std::map<Name, PendingFetch> m_pendingFetches;
+  ptr_lib::shared_ptr<boost::asio::io_service> m_fetchIoService;
+  boost::posix_time::time_duration m_fetchDeadline;
+  ptr_lib::shared_ptr<CallbackGuard> m_callbackGuard;
+
+  // the issuer learned for each key locator, and the certificates being prefetched, with the
+  // ids of their pending Interests, or already prefetched
+  struct PredictedIssuer
+  {
+    Name m_certificateName;
+    Name m_issuerName;
+  };
+  ptr_lib::shared_ptr<Face> m_prefetchFace;
+  std::map<Name, PredictedIssuer> m_predictedIssuers;
+  std::map<Name, const PendingInterestId*> m_prefetching;
+  std::map<Name, ptr_lib::shared_ptr<Data> > m_prefetched;
+
+  // guards the fetch and prefetch state
+  boost::mutex m_pendingMutex;
+
+  // the verifications queued to the pool and not finished, which use this policy
+  size_t m_poolTaskCount;
+  boost::mutex m_poolTaskMutex;
+  boost::condition_variable m_poolTaskFinished;
 };
 
 void 
 SecPolicySimple::addSigningPolicyRule (ptr_lib::shared_ptr<SecRuleRelative> rule)
-{ rule->isPositive() ? m_signPolicies.push_back(rule) : m_mustFailSign.push_back(rule); }
+{
+  checkComplexity(rule->getDataComplexity(), rule->getDataRegex());
+  checkComplexity(rule->getSignerComplexity(), rule->getSignerRegex());
+  rule->isPositive() ? m_signPolicies.push_back(rule) : m_mustFailSign.push_back(rule);
+}
 
 void
 SecPolicySimple::addSigningInference (ptr_lib::shared_ptr<Regex> inference)
-{ m_signInference.push_back(inference); }
+{
+  checkComplexity(RegexComplexity(*inference), inference->getExpr());
+  m_signInference.push_back(inference);
+}
 
 void 
 SecPolicySimple::addVerificationPolicyRule (ptr_lib::shared_ptr<SecRuleRelative> rule)
-{ rule->isPositive() ? m_verifyPolicies.push_back(rule) : m_mustFailVerify.push_back(rule); }
+{
+  checkComplexity(rule->getDataComplexity(), rule->getDataRegex());
+  checkComplexity(rule->getSignerComplexity(), rule->getSignerRegex());
+  rule->isPositive() ? m_verifyPolicies.push_back(rule) : m_mustFailVerify.push_back(rule);
+  if(static_cast<bool>(m_ruleDecisionCache))
+    m_ruleDecisionCache->invalidate();
+}
       
 void 
 SecPolicySimple::addVerificationExemption (ptr_lib::shared_ptr<Regex> exempt)
-{ m_verifyExempt.push_back(exempt); }
+{
+  checkComplexity(RegexComplexity(*exempt), exempt->getExpr());
+  m_verifyExempt.push_back(exempt);
+}
+
+void
+SecPolicySimple::addDigestExemption (ptr_lib::shared_ptr<Regex> exempt)
+{
+  checkComplexity(RegexComplexity(*exempt), exempt->getExpr());
+  m_digestExempt.push_back(exempt);
+}
+
+void
+SecPolicySimple::setRegexDegreeLimit(int maxDegree)
+{ m_regexDegreeLimit = maxDegree; }
+
+void
+SecPolicySimple::setRuleDecisionCache(ptr_lib::shared_ptr<RuleDecisionCache> cache)
+{
+  m_ruleDecisionCache = cache;
+  if(static_cast<bool>(m_ruleDecisionCache))
+    m_ruleDecisionCache->invalidate();
+}
+
+void
+SecPolicySimple::setVerificationResultCache(ptr_lib::shared_ptr<VerificationResultCache> cache)
+{ m_verificationResultCache = cache; }
+
+void
+SecPolicySimple::setNegativeCertificateCache(ptr_lib::shared_ptr<NegativeCertificateCache> cache)
+{ m_negativeCertificateCache = cache; }
+
+void
+SecPolicySimple::setVerifiedChainCache(ptr_lib::shared_ptr<VerifiedChainCache> cache)
+{ m_verifiedChainCache = cache; }
+
+void
+SecPolicySimple::setPrefetchFace(ptr_lib::shared_ptr<Face> face)
+{ m_prefetchFace = face; }
+
+void
+SecPolicySimple::setVerificationPool(ptr_lib::shared_ptr<WorkStealingPool> pool,
+                                     ptr_lib::shared_ptr<boost::asio::io_service> ioService)
+{
+  if(static_cast<bool>(pool) && !static_cast<bool>(ioService))
+    throw Error("SecPolicySimple: a verification pool needs an io_service");
+
+  m_verificationPool = pool;
+  m_ioService = ioService;
+}
+
+void
+SecPolicySimple::setFetchDeadline(ptr_lib::shared_ptr<boost::asio::io_service> ioService, int milliseconds)
+{
+  m_fetchIoService = ioService;
+  m_fetchDeadline = boost::posix_time::milliseconds(milliseconds);
+}
 
 void  
 SecPolicySimple::addTrustAnchor(ptr_lib::shared_ptr<IdentityCertificate> certificate)
-{ m_trustAnchors[certificate->getName().getPrefix(-1)] = certificate; }
+{
+  Name keyName = certificate->getName().getPrefix(-1);
+  m_trustAnchors[keyName] = certificate;
+
+  // a key that cannot be decoded here is left to Verifier
+  ptr_lib::shared_ptr<const DecodedPublicKey> decodedKey = DecodedPublicKey::decode(certificate->getPublicKeyInfo());
+  if(static_cast<bool>(decodedKey))
+    m_trustAnchorKeys[keyName] = decodedKey;
+  else
+    m_trustAnchorKeys.erase(keyName);
+}
 
 }//ndn
 
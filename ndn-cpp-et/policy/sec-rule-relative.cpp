@@ -10,6 +10,8 @@
 #include <ndn-cpp-dev/security/signature-sha256-with-rsa.hpp>
 #include <ndn-cpp-dev/security/security-common.hpp>
 
+#include <string.h>
+
 
 
 #include "logging.h"
@@ -30,7 +32,11 @@ SecRuleRelative::SecRuleRelative (const string& dataRegex, const string& signerR
     m_dataExpand(dataExpand),
     m_signerExpand(signerExpand),
     m_dataNameRegex(dataRegex, dataExpand),
-    m_signerNameRegex(signerRegex, signerExpand)
+    m_signerNameRegex(signerRegex, signerExpand),
+    m_dataExpandPattern(dataExpand),
+    m_signerExpandPattern(signerExpand),
+    m_dataComplexity(m_dataNameRegex),
+    m_signerComplexity(m_signerNameRegex)
 {
   if(op != ">" && op != ">=" && op != "==")
     throw Error("op is wrong!");
@@ -41,74 +47,78 @@ SecRuleRelative::~SecRuleRelative()
 
 bool 
 SecRuleRelative::satisfy (const Data& data)
+{ return satisfy(VerificationContext(data)); }
+
+bool
+SecRuleRelative::satisfy (const VerificationContext& context)
 {
-  Name dataName = data.getName();
-  try{
-    SignatureSha256WithRsa sig(data.getSignature());
-    Name signerName = sig.getKeyLocator().getName ();
-    return satisfy (dataName, signerName); 
-  }catch(SignatureSha256WithRsa::Error &e){
+  if(!context.hasSignerName())
     return false;
-  }catch(KeyLocator::Error &e){
-    return false;
-  }
+  return satisfy(context.getDataView(), context.getSignerView());
 }
   
 bool 
 SecRuleRelative::satisfy (const Name& dataName, const Name& signerName)
+{ return satisfy(RegexNameView(dataName), RegexNameView(signerName)); }
+
+bool
+SecRuleRelative::satisfy (const RegexNameView& dataName, const RegexNameView& signerName)
 {
+  // the expanded names are spans of dataName and signerName, compared in place
   if(!m_dataNameRegex.match(dataName))
     return false;
-  Name expandDataName = m_dataNameRegex.expand();
+  m_dataNameRegex.expand(m_dataExpandPattern, dataName, m_expandedDataName);
 
   if(!m_signerNameRegex.match(signerName))
     return false;
-  Name expandSignerName =  m_signerNameRegex.expand();
-  
-  bool matched = compare(expandDataName, expandSignerName);
+  m_signerNameRegex.expand(m_signerExpandPattern, signerName, m_expandedSignerName);
   
-  return matched;
+  return compare(m_expandedDataName, m_expandedSignerName);
 }
 
 bool 
 SecRuleRelative::matchDataName (const Data& data)
 { return m_dataNameRegex.match(data.getName()); }
 
+bool
+SecRuleRelative::matchDataName (const RegexNameView& dataName)
+{ return m_dataNameRegex.match(dataName); }
+
 bool
 SecRuleRelative::matchSignerName (const Data& data)
-{    
-  try{
-    SignatureSha256WithRsa sig(data.getSignature());
-    Name signerName = sig.getKeyLocator().getName ();
-    return m_signerNameRegex.match(signerName); 
-  }catch(SignatureSha256WithRsa::Error &e){
-    return false;
-  }catch(KeyLocator::Error &e){
+{ return matchSignerName(VerificationContext(data)); }
+
+bool
+SecRuleRelative::matchDataName (const VerificationContext& context)
+{ return m_dataNameRegex.match(context.getDataView()); }
+
+bool
+SecRuleRelative::matchSignerName (const VerificationContext& context)
+{
+  if(!context.hasSignerName())
     return false;
-  }
+  return m_signerNameRegex.match(context.getSignerView());
 }
 
 bool 
-SecRuleRelative::compare(const Name & dataName, const Name & signerName)
+SecRuleRelative::compare(const RegexExpandPattern::ValueList& dataName,
+                         const RegexExpandPattern::ValueList& signerName)
 {  
-  if((dataName == signerName) && ("==" == m_op || ">=" == m_op))
-    return true;
-    
-  Name::const_iterator i = dataName.begin ();
-  Name::const_iterator j = signerName.begin ();
+  // the signer name must be a prefix of the data name, equal to it only if op allows
+  if(dataName.size() < signerName.size())
+    return false;
 
-  for (; i != dataName.end () && j != signerName.end (); i++, j++)
+  for(size_t i = 0; i < signerName.size(); i++)
     {
-      if ((i->compare(*j)) == 0)
-        continue;
-      else
+      if(dataName[i].second != signerName[i].second ||
+         0 != memcmp(dataName[i].first, signerName[i].first, dataName[i].second))
         return false;
     }
-    
-  if(i == dataName.end())
-    return false;
-  else 
+
+  if(dataName.size() > signerName.size())
     return true;
+  else
+    return "==" == m_op || ">=" == m_op;
 }
 
 }//ndn
@@ -11,6 +11,7 @@
 
 #include "sec-rule.hpp"
 #include "../regex/regex.hpp"
+#include "../regex/regex-complexity.hpp"
 
 namespace ndn
 {
@@ -37,10 +38,54 @@ public:
   
   virtual bool
   satisfy(const Name& dataName, const Name& signerName);
+
+  virtual bool
+  matchDataName(const VerificationContext& context);
+
+  virtual bool
+  matchSignerName(const VerificationContext& context);
+
+  virtual bool
+  satisfy(const VerificationContext& context);
+
+  /**
+   * @brief match the data name given as a view, which may carry the memo of the names
+   *        matched by all the rules of a policy (see RegexMatchMemo)
+   */
+  bool
+  matchDataName(const RegexNameView& dataName);
+
+  bool
+  satisfy(const RegexNameView& dataName, const RegexNameView& signerName);
+
+  const std::string&
+  getDataRegex() const
+  { return m_dataRegex; }
+
+  const std::string&
+  getSignerRegex() const
+  { return m_signerRegex; }
+
+  const RegexComplexity&
+  getDataComplexity() const
+  { return m_dataComplexity; }
+
+  const RegexComplexity&
+  getSignerComplexity() const
+  { return m_signerComplexity; }
+
+  /**
+   * @brief estimate the number of component tests satisfy() does in the worst case
+   * @param nameSize the number of components of the data and signer names
+   */
+  double
+  getCost(size_t nameSize) const
+  { return m_dataComplexity.getCost(nameSize) + m_signerComplexity.getCost(nameSize); }
   
 private:
   bool 
-  compare(const Name& dataName, const Name& signerName);
+  compare(const RegexExpandPattern::ValueList& dataName,
+          const RegexExpandPattern::ValueList& signerName);
   
 private:
   const std::string m_dataRegex;
@@ -51,6 +96,13 @@ private:
   
   Regex m_dataNameRegex;
   Regex m_signerNameRegex;
+  const RegexExpandPattern m_dataExpandPattern;
+  const RegexExpandPattern m_signerExpandPattern;
+  // reused by satisfy(), so that a rule evaluation does not allocate once they have grown
+  RegexExpandPattern::ValueList m_expandedDataName;
+  RegexExpandPattern::ValueList m_expandedSignerName;
+  RegexComplexity m_dataComplexity;
+  RegexComplexity m_signerComplexity;
 };
 
 }//ndn
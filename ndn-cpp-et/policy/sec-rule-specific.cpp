@@ -32,22 +32,24 @@ SecRuleSpecific::matchDataName(const Data& data)
 
 bool 
 SecRuleSpecific::matchSignerName(const Data& data)
-{ 
-  try{
-    SignatureSha256WithRsa sig(data.getSignature());
-    Name signerName = sig.getKeyLocator().getName ();
-    return m_signerRegex->match(signerName); 
-  }catch(SignatureSha256WithRsa::Error &e){
-    return false;
-  }catch(KeyLocator::Error &e){
-    return false;
-  }
-}
+{ return matchSignerName(VerificationContext(data)); }
 
 bool
 SecRuleSpecific::satisfy(const Data & data)
-{ return (matchDataName(data) && matchSignerName(data)) ? true : false ; }
+{ return satisfy(VerificationContext(data)); }
 
 bool
 SecRuleSpecific::satisfy(const Name & dataName, const Name & signerName)
 { return (m_dataRegex->match(dataName) && m_signerRegex->match(signerName)); }
+
+bool 
+SecRuleSpecific::matchDataName(const VerificationContext& context)
+{ return m_dataRegex->match(context.getDataView()); }
+
+bool 
+SecRuleSpecific::matchSignerName(const VerificationContext& context)
+{ return context.hasSignerName() && m_signerRegex->match(context.getSignerView()); }
+
+bool
+SecRuleSpecific::satisfy(const VerificationContext& context)
+{ return matchDataName(context) && matchSignerName(context); }
@@ -34,6 +34,15 @@ public:
 
   bool
   satisfy(const ndn::Name& dataName, const ndn::Name& signerName);
+
+  bool 
+  matchDataName(const ndn::VerificationContext& context);
+
+  bool 
+  matchSignerName(const ndn::VerificationContext& context);
+
+  bool
+  satisfy(const ndn::VerificationContext& context);
   
 private:
   ndn::ptr_lib::shared_ptr<ndn::Regex> m_dataRegex;
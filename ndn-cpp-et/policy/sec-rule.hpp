@@ -10,6 +10,8 @@
 
 #include <ndn-cpp-dev/data.hpp>
 
+#include "verification-context.hpp"
+
 namespace ndn
 {
 
@@ -37,6 +39,22 @@ public:
   
   virtual bool
   satisfy(const Name& dataName, const Name& signerName) = 0;
+
+  /**
+   * @brief check a data packet whose signature has been parsed once for all the rules,
+   *        the default implementations check context.getData()
+   */
+  virtual bool
+  matchDataName(const VerificationContext& context)
+  { return matchDataName(context.getData()); }
+
+  virtual bool
+  matchSignerName(const VerificationContext& context)
+  { return matchSignerName(context.getData()); }
+
+  virtual bool
+  satisfy(const VerificationContext& context)
+  { return satisfy(context.getData()); }
   
   inline bool
   isPositive();
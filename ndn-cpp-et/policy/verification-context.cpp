@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include "verification-context.hpp"
+
+#include "logging.h"
+
+INIT_LOGGER ("VerificationContext");
+
+using namespace std;
+
+namespace ndn
+{
+
+// parsed in the initializer list, the views are built on the signer name
+static bool
+parseSignerName(const Data& data, SignatureSha256WithRsa& signature, Name& signerName)
+{
+  // another signature type has no signer name, it is not parsed as SHA256withRSA and rejected
+  // by exception
+  if(Signature::Sha256WithRsa != data.getSignature().getType())
+    return false;
+
+  try{
+    signature = SignatureSha256WithRsa(data.getSignature());
+    signerName = signature.getKeyLocator().getName();
+    return true;
+  }catch(SignatureSha256WithRsa::Error &e){
+    return false;
+  }catch(KeyLocator::Error &e){
+    return false;
+  }
+}
+
+VerificationContext::VerificationContext(const Data& data)
+  : m_data(data),
+    m_hasSignerName(parseSignerName(data, m_signature, m_signerName)),
+    m_dataView(data.getName()),
+    m_dataMemo(m_dataView.size()),
+    m_signerView(m_signerName),
+    m_signerMemo(m_signerView.size()),
+    m_sharedSignerView(&m_signerView)
+{
+  m_dataView.setMemo(&m_dataMemo);
+  m_signerView.setMemo(&m_signerMemo);
+}
+
+const SignatureSha256WithRsa&
+VerificationContext::getSignature() const
+{
+  if(!m_hasSignerName)
+    throw Error("Data " + m_data.getName().toUri() + " has no signer name");
+  return m_signature;
+}
+
+const Name&
+VerificationContext::getSignerName() const
+{
+  if(!m_hasSignerName)
+    throw Error("Data " + m_data.getName().toUri() + " has no signer name");
+  return m_signerName;
+}
+
+void
+VerificationContext::shareSignerView(const VerificationContext& other)
+{
+  if(!m_hasSignerName || !other.m_hasSignerName || m_signerName != other.m_signerName)
+    throw Error("Data " + m_data.getName().toUri() + " is not signed by the signer of "
+                + other.m_data.getName().toUri());
+  m_sharedSignerView = other.m_sharedSignerView;
+}
+
+}//ndn
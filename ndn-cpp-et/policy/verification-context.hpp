@@ -0,0 +1,109 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_VERIFICATION_CONTEXT_HPP
+#define NDN_VERIFICATION_CONTEXT_HPP
+
+#include <ndn-cpp-dev/data.hpp>
+#include <ndn-cpp-dev/security/signature-sha256-with-rsa.hpp>
+
+#include "../regex/regex-name-view.hpp"
+#include "../regex/regex-match-memo.hpp"
+
+namespace ndn
+{
+
+/**
+ * @brief The parts of a data packet checked by the rules of a policy, parsed once per packet.
+ *
+ * The signature and its key locator are decoded when the context is built, and the data
+ * and signer names are given to the rules as views sharing a RegexMatchMemo, so the cost
+ * of parsing does not grow with the number of rules.  The context refers to the data
+ * packet, which must outlive it.
+ */
+class VerificationContext
+{
+public:
+  struct Error : public std::runtime_error { Error(const std::string &what) : std::runtime_error(what) {} };
+
+  explicit
+  VerificationContext(const Data& data);
+
+  const Data&
+  getData() const
+  { return m_data; }
+
+  /**
+   * @brief get the type of the signature, see Signature::getType
+   */
+  uint32_t
+  getSignatureType() const
+  { return m_data.getSignature().getType(); }
+
+  /**
+   * @brief check if the data is signed with SHA256withRSA and its key locator is a name
+   */
+  bool
+  hasSignerName() const
+  { return m_hasSignerName; }
+
+  /**
+   * @brief get the parsed signature
+   * @throws Error if there is no signer name
+   */
+  const SignatureSha256WithRsa&
+  getSignature() const;
+
+  /**
+   * @brief get the key locator name
+   * @throws Error if there is no signer name
+   */
+  const Name&
+  getSignerName() const;
+
+  const RegexNameView&
+  getDataView() const
+  { return m_dataView; }
+
+  /**
+   * @brief get the view of the signer name, empty if there is no signer name
+   */
+  const RegexNameView&
+  getSignerView() const
+  { return *m_sharedSignerView; }
+
+  /**
+   * @brief match the signer name on the view of another context with the same signer name,
+   *        so that the packets of one signer share the sub-pattern results of its memo;
+   *        other must outlive this context
+   * @throws Error if the signer names differ
+   */
+  void
+  shareSignerView(const VerificationContext& other);
+
+private:
+  VerificationContext(const VerificationContext&);
+
+  VerificationContext&
+  operator=(const VerificationContext&);
+
+private:
+  const Data& m_data;
+  SignatureSha256WithRsa m_signature;
+  Name m_signerName;
+  bool m_hasSignerName;
+
+  RegexNameView m_dataView;
+  RegexMatchMemo m_dataMemo;
+  RegexNameView m_signerView;
+  RegexMatchMemo m_signerMemo;
+  const RegexNameView* m_sharedSignerView;
+};
+
+}//ndn
+
+#endif
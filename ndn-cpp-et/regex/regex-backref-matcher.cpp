@@ -28,6 +28,14 @@ namespace ndn
     // _LOG_TRACE ("Exit RegexBackrefMatcher Constructor: ");
   }
 
+  RegexBackrefMatcher::RegexBackrefMatcher(const string expr, 
+                                           ptr_lib::shared_ptr<RegexBackrefManager> backRefManager,
+                                           ptr_lib::shared_ptr<RegexMatcher> patternList)
+    : RegexMatcher (expr, EXPR_BACKREF, backRefManager)
+  {
+    m_matcherList.push_back(patternList);
+  }
+
   void 
   RegexBackrefMatcher::compile()
   {
@@ -19,6 +19,16 @@ namespace ndn
   {
   public:
     RegexBackrefMatcher(const std::string expr, ptr_lib::shared_ptr<RegexBackrefManager> backRefManager);
+
+    /**
+     * @brief Create a RegexBackrefMatcher from an already compiled pattern list, lateCompile() must not be called
+     * @param expr The expression the pattern list was compiled from, including parentheses
+     * @param backRefManager The back reference manager
+     * @param patternList The compiled pattern list inside the parentheses
+     */
+    RegexBackrefMatcher(const std::string expr, 
+                        ptr_lib::shared_ptr<RegexBackrefManager> backRefManager,
+                        ptr_lib::shared_ptr<RegexMatcher> patternList);
     
     virtual ~RegexBackrefMatcher(){}
 
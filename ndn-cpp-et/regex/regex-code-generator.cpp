@@ -0,0 +1,495 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <limits>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "regex-code-generator.hpp"
+#include "regex-repeat-matcher.hpp"
+#include "regex-component-predicate.hpp"
+
+#include "logging.h"
+
+INIT_LOGGER ("RegexCodeGenerator");
+
+using namespace std;
+
+namespace ndn
+{
+  static bool
+  isRegexSpecial(char c)
+  { return 0 != c && 0 != strchr(".[]{}()\\*+?|^$", c); }
+
+  /**
+   * @brief extract the literal text from a component expression of the form "literal" or "literal.*"
+   * @returns false if the expression contains any other regex construct
+   */
+  static bool
+  extractLiteral(const string& expr, string& literal, bool& isPrefix)
+  {
+    literal.clear();
+    isPrefix = false;
+
+    size_t i = 0;
+    while(i < expr.size())
+      {
+        char c = expr[i];
+        if('\\' == c)
+          {
+            if(i + 1 >= expr.size() || !isRegexSpecial(expr[i + 1]))
+              return false;
+            literal.push_back(expr[i + 1]);
+            i += 2;
+          }
+        else if('.' == c && i + 2 == expr.size() && '*' == expr[i + 1])
+          {
+            isPrefix = true;
+            return true;
+          }
+        else if(isRegexSpecial(c))
+          return false;
+        else
+          {
+            literal.push_back(c);
+            i++;
+          }
+      }
+    return true;
+  }
+
+  // Same escaping as Name::Component::toEscapedString, on which component expressions are evaluated
+  static string
+  escapeComponent(const string& raw)
+  {
+    return RegexNameView::escape(reinterpret_cast<const uint8_t*>(raw.c_str()), raw.size());
+  }
+
+  /**
+   * @brief convert escaped text back to component bytes
+   * @returns false if escaped is not what toEscapedString would produce for any component
+   */
+  static bool
+  unescapeComponent(const string& escaped, string& raw)
+  {
+    raw.clear();
+    if(string::npos == escaped.find_first_not_of('.'))
+      {
+        if(escaped.size() < 3)
+          return false;
+        raw = escaped.substr(3);
+        return true;
+      }
+
+    for(size_t i = 0; i < escaped.size(); i++)
+      {
+        if('%' == escaped[i])
+          {
+            if(i + 2 >= escaped.size() || !isxdigit(escaped[i + 1]) || !isxdigit(escaped[i + 2]))
+              return false;
+            raw.push_back(static_cast<char>(strtol(escaped.substr(i + 1, 2).c_str(), NULL, 16)));
+            i += 2;
+          }
+        else
+          raw.push_back(escaped[i]);
+      }
+    return escapeComponent(raw) == escaped;
+  }
+
+  RegexCodeGenerator::RegexCodeGenerator()
+    : m_predicateCount(0),
+      m_regexCount(0)
+  {}
+
+  bool
+  RegexCodeGenerator::addExpression(const string& expr)
+  {
+    RegexTopMatcher topMatcher(expr);
+
+    // The secondary matcher, when present, also covers every match of the primary one.
+    ptr_lib::shared_ptr<RegexPatternListMatcher> patternList = topMatcher.getSecondaryMatcher();
+    if(!static_cast<bool>(patternList))
+      patternList = topMatcher.getPrimaryMatcher();
+
+    int regexCount = m_regexCount;
+    string declarations = m_declarations.str();
+    m_predicates.clear();
+
+    vector<Element> elements;
+    if(!flattenPatternList(*patternList, elements))
+      {
+        _LOG_DEBUG ("RegexCodeGenerator: unsupported expression " << expr);
+        m_regexCount = regexCount;
+        m_declarations.str(declarations);
+        m_declarations.seekp(0, ios_base::end);
+        return false;
+      }
+
+    generateElements(elements);
+    m_exprs.push_back(expr);
+    return true;
+  }
+
+  bool
+  RegexCodeGenerator::flattenPatternList(const RegexMatcher& patternList, vector<Element>& elements)
+  {
+    const vector<ptr_lib::shared_ptr<RegexMatcher> >& matchers = patternList.getMatcherList();
+    vector<ptr_lib::shared_ptr<RegexMatcher> >::const_iterator it = matchers.begin();
+    for(; it != matchers.end(); it++)
+      {
+        switch((*it)->getType()){
+        case RegexMatcher::EXPR_REPEAT_PATTERN:
+          {
+            const RegexRepeatMatcher& repeat = static_cast<const RegexRepeatMatcher&>(**it);
+            const RegexMatcher& inner = *repeat.getMatcherList()[0];
+
+            if(RegexMatcher::EXPR_COMPONENT_SET == inner.getType())
+              {
+                Element element;
+                element.m_predicates.push_back(generatePredicate(static_cast<const RegexComponentSetMatcher&>(inner),
+                                                                 element.m_any));
+                element.m_repeatMin = repeat.getRepeatMin();
+                element.m_repeatMax = repeat.getRepeatMax();
+                elements.push_back(element);
+              }
+            else if(RegexMatcher::EXPR_BACKREF == inner.getType())
+              {
+                vector<Element> body;
+                if(!flattenPatternList(*inner.getMatcherList()[0], body))
+                  return false;
+
+                if(1 == repeat.getRepeatMin() && 1 == repeat.getRepeatMax())
+                  {
+                    elements.insert(elements.end(), body.begin(), body.end());
+                    break;
+                  }
+
+                // Only groups of a fixed number of components are lowered to loops.
+                Element group;
+                group.m_any = (1 == body.size() && body[0].m_any);
+                vector<Element>::const_iterator bodyIt = body.begin();
+                for(; bodyIt != body.end(); bodyIt++)
+                  {
+                    if(1 != bodyIt->m_repeatMin || 1 != bodyIt->m_repeatMax)
+                      return false;
+                    group.m_predicates.insert(group.m_predicates.end(),
+                                              bodyIt->m_predicates.begin(), bodyIt->m_predicates.end());
+                  }
+
+                if(group.m_predicates.empty())
+                  break;
+
+                group.m_repeatMin = repeat.getRepeatMin();
+                group.m_repeatMax = repeat.getRepeatMax();
+                elements.push_back(group);
+              }
+            else
+              return false;
+            break;
+          }
+        case RegexMatcher::EXPR_BACKREF:
+          if(!flattenPatternList(*(*it)->getMatcherList()[0], elements))
+            return false;
+          break;
+        default:
+          return false;
+        }
+      }
+    return true;
+  }
+
+  string
+  RegexCodeGenerator::generatePredicate(const RegexComponentSetMatcher& componentSet, bool& any)
+  {
+    ostringstream name;
+    name << "predicate" << m_predicateCount++;
+
+    any = false;
+    vector<string> terms;
+    const set<ptr_lib::shared_ptr<RegexComponentMatcher> >& components = componentSet.getComponents();
+    set<ptr_lib::shared_ptr<RegexComponentMatcher> >::const_iterator it = components.begin();
+    for(; it != components.end(); it++)
+      {
+        string term = generateComponentTerm((*it)->getExpr());
+        if("true" == term)
+          any = true;
+        terms.push_back(term);
+      }
+
+    ostringstream function;
+    function << "  static bool" << endl
+             << "  " << name.str() << "(const ndn::RegexNameView& name, size_t index)" << endl
+             << "  {" << endl;
+
+    if(any)
+      function << "    return " << (componentSet.isInclusive() ? "true" : "false") << ";" << endl;
+    else
+      {
+        function << "    return " << (componentSet.isInclusive() ? "" : "!") << "(";
+        for(size_t i = 0; i < terms.size(); i++)
+          {
+            if(i > 0)
+              function << endl << "            || ";
+            function << terms[i];
+          }
+        function << ");" << endl;
+      }
+
+    function << "  }" << endl << endl;
+    m_predicates[name.str()] = function.str();
+
+    any = any && componentSet.isInclusive();
+    return name.str();
+  }
+
+  string
+  RegexCodeGenerator::generateComponentTerm(const string& componentExpr)
+  {
+    if("" == componentExpr || ".*" == componentExpr)
+      return "true";
+
+    string pattern;
+    if(RegexComponentMatcher::parseContains(componentExpr, pattern))
+      {
+        ostringstream searchName;
+        searchName << "search" << m_regexCount++;
+
+        string needle;
+        if(RegexComponentMatcher::unescapeLiteral(pattern, needle))
+          {
+            m_declarations << "  static const ndn::RegexSubstringSearcher " << searchName.str()
+                           << "(std::string(" << toCString(needle) << ", " << needle.size() << "));" << endl;
+            return "(0 != " + searchName.str() + ".find(name.getValue(index), name.getValueSize(index)))";
+          }
+
+        m_declarations << "  static const boost::regex " << searchName.str()
+                       << "(" << toCString(pattern) << ");" << endl;
+        return "boost::regex_search(name.toEscapedString(index), " + searchName.str() + ")";
+      }
+
+    if(RegexComponentPredicate::isPredicate(componentExpr))
+      {
+        // parse it here, so that a malformed predicate is reported by the generator
+        RegexComponentPredicate predicate(componentExpr);
+
+        ostringstream typedName;
+        typedName << "typed" << m_regexCount++;
+        m_declarations << "  static const ndn::RegexComponentPredicate " << typedName.str()
+                       << "(" << toCString(componentExpr) << ");" << endl;
+        return typedName.str() + ".match(name.getValue(index), name.getValueSize(index))";
+      }
+
+    string literal;
+    bool isPrefix;
+    string raw;
+    if(extractLiteral(componentExpr, literal, isPrefix) &&
+       (!isPrefix || string::npos != literal.find_first_not_of('.')) &&
+       unescapeComponent(literal, raw))
+      {
+        ostringstream term;
+        if(raw.empty())
+          term << "(name.getValueSize(index) " << (isPrefix ? ">=" : "==") << " 0)";
+        else
+          term << "(name.getValueSize(index) " << (isPrefix ? ">=" : "==") << " " << raw.size()
+               << " && 0 == memcmp(name.getValue(index), " << toCString(raw) << ", " << raw.size() << "))";
+        return term.str();
+      }
+
+    ostringstream regexName;
+    regexName << "regex" << m_regexCount++;
+    m_declarations << "  static const boost::regex " << regexName.str()
+                   << "(" << toCString(componentExpr) << ");" << endl;
+    return "boost::regex_match(name.toEscapedString(index), " + regexName.str() + ")";
+  }
+
+  void
+  RegexCodeGenerator::generateElements(const vector<Element>& input)
+  {
+    // merge consecutive single occurrences into one unrolled block
+    vector<Element> elements;
+    vector<Element>::const_iterator it = input.begin();
+    for(; it != input.end(); it++)
+      {
+        if(!elements.empty() && 1 == it->m_repeatMin && 1 == it->m_repeatMax &&
+           1 == elements.back().m_repeatMin && 1 == elements.back().m_repeatMax)
+          {
+            elements.back().m_predicates.insert(elements.back().m_predicates.end(),
+                                                it->m_predicates.begin(), it->m_predicates.end());
+            elements.back().m_any = false;
+          }
+        else
+          elements.push_back(*it);
+      }
+
+    const int intMax = numeric_limits<int>::max();
+    ostringstream prefix;
+    prefix << "match" << m_exprs.size();
+
+    // A trailing <.*>* accepts whatever is left, so no end-of-name check is needed after it.
+    bool isLastAny = (!elements.empty() && elements.back().m_any && intMax == elements.back().m_repeatMax);
+
+    // Emit only the predicates that are called, the trailing <.*>* does not test its components.
+    for(size_t i = 0; i < elements.size() - (isLastAny ? 1 : 0); i++)
+      {
+        vector<string>::const_iterator predicateIt = elements[i].m_predicates.begin();
+        for(; predicateIt != elements[i].m_predicates.end(); predicateIt++)
+          {
+            map<string, string>::iterator function = m_predicates.find(*predicateIt);
+            if(function != m_predicates.end())
+              {
+                m_functions << function->second;
+                m_predicates.erase(function);
+              }
+          }
+      }
+
+    // Each element calls the next one, so emit them in reverse order.
+    if(!isLastAny)
+      m_functions << "  static bool" << endl
+                  << "  " << prefix.str() << "_" << elements.size() << "(const ndn::RegexNameView& name, size_t offset)" << endl
+                  << "  { return name.size() == offset; }" << endl << endl;
+
+    for(int i = elements.size() - 1; i >= 0; i--)
+      {
+        const Element& element = elements[i];
+        const int width = element.m_predicates.size();
+
+        ostringstream next;
+        next << prefix.str() << "_" << (i + 1) << "(name, offset)";
+
+        ostringstream condition;
+        for(int j = 0; j < width; j++)
+          {
+            condition << (j > 0 ? " && " : "") << element.m_predicates[j] << "(name, offset";
+            if(j > 0)
+              condition << " + " << j;
+            condition << ")";
+          }
+
+        m_functions << "  static bool" << endl
+                    << "  " << prefix.str() << "_" << i << "(const ndn::RegexNameView& name, size_t offset)" << endl
+                    << "  {" << endl;
+
+        if(1 == element.m_repeatMin && 1 == element.m_repeatMax)
+          {
+            m_functions << "    if (name.size() < offset + " << width << ")" << endl
+                        << "      return false;" << endl;
+            for(int j = 0; j < width; j++)
+              {
+                m_functions << "    if (!" << element.m_predicates[j] << "(name, offset";
+                if(j > 0)
+                  m_functions << " + " << j;
+                m_functions << "))" << endl
+                            << "      return false;" << endl;
+              }
+            m_functions << "    offset += " << width << ";" << endl
+                        << "    return " << next.str() << ";" << endl;
+          }
+        else if(isLastAny && i + 1 == static_cast<int>(elements.size()))
+          {
+            if(element.m_repeatMin > 0)
+              m_functions << "    return name.size() >= offset + " << element.m_repeatMin << ";" << endl;
+            else
+              m_functions << "    return true;" << endl;
+          }
+        else
+          {
+            bool counted = (element.m_repeatMin > 0 || intMax != element.m_repeatMax);
+            if(counted)
+              m_functions << "    int count = 0;" << endl;
+            if(element.m_repeatMin > 0)
+              m_functions << "    for (; count < " << element.m_repeatMin << "; count++)" << endl
+                          << "      {" << endl
+                          << "        if (name.size() < offset + " << width << " || !(" << condition.str() << "))" << endl
+                          << "          return false;" << endl
+                          << "        offset += " << width << ";" << endl
+                          << "      }" << endl;
+            m_functions << "    for (;;)" << endl
+                        << "      {" << endl
+                        << "        if (" << next.str() << ")" << endl
+                        << "          return true;" << endl
+                        << "        if (";
+            if(intMax != element.m_repeatMax)
+              m_functions << "count >= " << element.m_repeatMax << " || ";
+            m_functions << "name.size() < offset + " << width << " || !(" << condition.str() << "))" << endl
+                        << "          return false;" << endl
+                        << "        offset += " << width << ";" << endl;
+            if(counted)
+              m_functions << "        count++;" << endl;
+            m_functions << "      }" << endl;
+          }
+
+        m_functions << "  }" << endl << endl;
+      }
+
+    m_functions << "  static bool" << endl
+                << "  " << prefix.str() << "(const ndn::RegexNameView& name)" << endl
+                << "  { return " << prefix.str() << "_0(name, 0); }" << endl << endl;
+  }
+
+  void
+  RegexCodeGenerator::generate(ostream& os) const
+  {
+    os << "// Generated by ndn-regex-codegen, do not edit." << endl
+       << endl
+       << "#include <string.h>" << endl
+       << "#include <boost/regex.hpp>" << endl
+       << "#include <ndn-cpp-et/regex/regex-native-registry.hpp>" << endl
+       << "#include <ndn-cpp-et/regex/regex-component-predicate.hpp>" << endl
+       << "#include <ndn-cpp-et/regex/regex-substring-searcher.hpp>" << endl
+       << endl
+       << "namespace" << endl
+       << "{" << endl
+       << m_declarations.str() << endl
+       << m_functions.str()
+       << "  struct RegexNativeRegistrar" << endl
+       << "  {" << endl
+       << "    RegexNativeRegistrar()" << endl
+       << "    {" << endl;
+
+    for(size_t i = 0; i < m_exprs.size(); i++)
+      os << "      ndn::RegexNativeRegistry::registerMatcher(" << toCString(m_exprs[i]) << ", &match" << i << ");" << endl;
+
+    os << "    }" << endl
+       << "  } regexNativeRegistrar;" << endl
+       << "}" << endl;
+  }
+
+  string
+  RegexCodeGenerator::toCString(const string& str)
+  {
+    string result("\"");
+    bool lastIsHex = false;
+    for(size_t i = 0; i < str.size(); i++)
+      {
+        unsigned char c = str[i];
+        if('\\' == c || '"' == c)
+          {
+            result.push_back('\\');
+            result.push_back(c);
+            lastIsHex = false;
+          }
+        else if(c >= 0x20 && c < 0x7f && !(lastIsHex && isxdigit(c)))
+          {
+            result.push_back(c);
+            lastIsHex = false;
+          }
+        else
+          {
+            char hex[5];
+            snprintf(hex, sizeof(hex), "\\x%02x", c);
+            result.append(hex);
+            lastIsHex = true;
+          }
+      }
+    result.push_back('"');
+    return result;
+  }
+
+}//ndn
@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_REGEX_CODE_GENERATOR_H
+#define NDN_REGEX_CODE_GENERATOR_H
+
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "regex-top-matcher.hpp"
+#include "regex-component-set-matcher.hpp"
+
+namespace ndn
+{
+  /**
+   * @brief Generate a C++ translation unit with one specialized match function per expression.
+   *
+   * Single-component patterns are compared inline (literal components with memcmp),
+   * repetitions are lowered to loops, and every generated function registers itself
+   * in RegexNativeRegistry under its expression string.
+   *
+   * Other component regexes are still evaluated by boost::regex on the escaped component,
+   * and an expression with back references still runs the interpreted matchers after the
+   * native one accepts the name, to collect the captures.
+   */
+  class RegexCodeGenerator
+  {
+  public:
+    RegexCodeGenerator();
+
+    /**
+     * @brief compile an expression into a native match function
+     * @param expr the regular expression
+     * @returns true if a function is generated, false if the expression is not supported
+     *          and will be left to the interpreted matchers
+     */
+    bool
+    addExpression(const std::string& expr);
+
+    /**
+     * @brief write the translation unit
+     * @param os the output stream
+     */
+    void
+    generate(std::ostream& os) const;
+
+  private:
+    struct Element
+    {
+      std::vector<std::string> m_predicates;
+      int m_repeatMin;
+      int m_repeatMax;
+      bool m_any;
+    };
+
+    bool
+    flattenPatternList(const RegexMatcher& patternList, std::vector<Element>& elements);
+
+    std::string
+    generatePredicate(const RegexComponentSetMatcher& componentSet, bool& any);
+
+    std::string
+    generateComponentTerm(const std::string& componentExpr);
+
+    void
+    generateElements(const std::vector<Element>& elements);
+
+    static std::string
+    toCString(const std::string& str);
+
+  private:
+    std::vector<std::string> m_exprs;
+    std::map<std::string, std::string> m_predicates;
+    std::ostringstream m_declarations;
+    std::ostringstream m_functions;
+    int m_predicateCount;
+    int m_regexCount;
+  };
+
+}//ndn
+
+#endif
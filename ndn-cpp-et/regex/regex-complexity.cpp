@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <math.h>
+#include <limits>
+
+#include "regex-complexity.hpp"
+#include "regex-repeat-matcher.hpp"
+#include "regex-exception.hpp"
+
+#include "logging.h"
+
+INIT_LOGGER ("RegexComplexity");
+
+using namespace std;
+
+namespace ndn
+{
+  RegexComplexity::RegexComplexity(const RegexTopMatcher& matcher)
+    : m_degree(1),
+      m_exponential(false),
+      m_ambiguous(false)
+  {
+    // a RegexLiteralMatcher has no matcher tree, it compares the prefix once
+    if(!static_cast<bool>(matcher.getPrimaryMatcher()))
+      return;
+
+    m_degree = analyze(*matcher.getPrimaryMatcher()).m_degree;
+    if(static_cast<bool>(matcher.getSecondaryMatcher()))
+      {
+        // the secondary matcher repeats the primary one after <.*>*, report its problems once
+        size_t problemCount = m_problems.size();
+        m_degree = max(m_degree, analyze(*matcher.getSecondaryMatcher()).m_degree);
+        m_problems.resize(problemCount);
+      }
+  }
+
+  double
+  RegexComplexity::getCost(size_t nameSize) const
+  {
+    if(m_exponential)
+      return pow(2.0, static_cast<double>(nameSize));
+    else
+      return pow(static_cast<double>(max<size_t>(nameSize, 1)), m_degree);
+  }
+
+  RegexComplexity::Info
+  RegexComplexity::analyze(const RegexMatcher& matcher)
+  {
+    Info info;
+
+    switch(matcher.getType()){
+    case RegexMatcher::EXPR_COMPONENT_SET:
+      // tests one component, and rejects any other length right away
+      info.m_degree = 0;
+      info.m_variable = false;
+      info.m_empty = false;
+      break;
+
+    case RegexMatcher::EXPR_BACKREF:
+      info = analyze(*matcher.getMatcherList()[0]);
+      break;
+
+    case RegexMatcher::EXPR_PATTERNLIST:
+      {
+        // Each element is tried on every remaining length, and every length it accepts
+        // multiplies the number of splits the following elements are tried on.
+        const vector<ptr_lib::shared_ptr<RegexMatcher> >& matcherList = matcher.getMatcherList();
+        int splits = 0;
+        info.m_degree = 0;
+        info.m_variable = false;
+        info.m_empty = true;
+        for(size_t i = 0; i < matcherList.size(); i++)
+          {
+            Info element = analyze(*matcherList[i]);
+            info.m_degree = max(info.m_degree, 1 + element.m_degree + splits);
+            if(element.m_variable)
+              splits++;
+            info.m_variable = info.m_variable || element.m_variable;
+            info.m_empty = info.m_empty && element.m_empty;
+          }
+        break;
+      }
+
+    case RegexMatcher::EXPR_REPEAT_PATTERN:
+      {
+        const RegexRepeatMatcher& repeat = static_cast<const RegexRepeatMatcher&>(matcher);
+        Info body = analyze(*repeat.getMatcherList()[0]);
+        bool unbounded = (numeric_limits<int>::max() == repeat.getRepeatMax());
+
+        bool varying = body.m_variable || body.m_empty;
+        if(varying && repeat.getRepeatMax() > 1)
+          {
+            m_ambiguous = true;
+            if(!unbounded)
+              m_problems.push_back(repeat.getExpr() + ": bounded repeat of a pattern of varying length");
+            else
+              {
+                m_exponential = true;
+                if(body.m_empty)
+                  m_problems.push_back(repeat.getExpr() + ": unbounded repeat of a pattern that can match no component");
+                else
+                  m_problems.push_back(repeat.getExpr() + ": unbounded repeat of a pattern of varying length");
+              }
+          }
+
+        // Every repetition tries every remaining length, one of them per repetition for a
+        // fixed-length body, and up to one per length for a body of varying length.
+        int repetitions = (unbounded ? 1 : 0);
+        if(varying && !unbounded)
+          repetitions = repeat.getRepeatMax() - 1;
+        info.m_degree = 1 + body.m_degree + repetitions;
+        info.m_variable = body.m_variable || repeat.getRepeatMin() != repeat.getRepeatMax();
+        info.m_empty = body.m_empty || 0 == repeat.getRepeatMin();
+        break;
+      }
+
+    default:
+      throw RegexException("RegexComplexity: cannot analyze matcher " + matcher.getExpr());
+    }
+
+    return info;
+  }
+
+}//ndn
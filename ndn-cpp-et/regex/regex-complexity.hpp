@@ -0,0 +1,88 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_REGEX_COMPLEXITY_H
+#define NDN_REGEX_COMPLEXITY_H
+
+#include <string>
+#include <vector>
+
+#include "regex-top-matcher.hpp"
+
+namespace ndn
+{
+  /**
+   * @brief Worst-case cost of matching a RegexTopMatcher, derived from its matcher tree.
+   *
+   * The interpreted matchers try every split of the name between the elements of a pattern
+   * list and between the repetitions of a repeat.  The cost is counted in component tests
+   * for a name of n components: O(n^degree), unless a repeat contains a sub-pattern that
+   * can match a varying number of components (e.g. (<a>*<b>*)*), which is exponential.
+   */
+  class RegexComplexity
+  {
+  public:
+    /**
+     * @brief analyze a matcher
+     * @param matcher The matcher to analyze
+     */
+    RegexComplexity(const RegexTopMatcher& matcher);
+
+    /**
+     * @brief get the degree of the worst-case cost polynomial, meaningless if isExponential()
+     */
+    int
+    getDegree() const
+    { return m_degree; }
+
+    bool
+    isExponential() const
+    { return m_exponential; }
+
+    /**
+     * @brief check if a repeat contains a sub-pattern of varying length, so that a name can
+     *        be split between the repetitions in more than one way
+     */
+    bool
+    isAmbiguous() const
+    { return m_ambiguous; }
+
+    /**
+     * @brief estimate the number of component tests in the worst case
+     * @param nameSize The number of components of the name
+     */
+    double
+    getCost(size_t nameSize) const;
+
+    /**
+     * @brief get the descriptions of the ambiguous and exponential sub-patterns
+     */
+    const std::vector<std::string>&
+    getProblems() const
+    { return m_problems; }
+
+  private:
+    struct Info
+    {
+      int m_degree;
+      bool m_variable;
+      bool m_empty;
+    };
+
+    Info
+    analyze(const RegexMatcher& matcher);
+
+  private:
+    int m_degree;
+    bool m_exponential;
+    bool m_ambiguous;
+    std::vector<std::string> m_problems;
+  };
+
+}//ndn
+
+#endif
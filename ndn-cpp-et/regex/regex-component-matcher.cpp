@@ -5,8 +5,13 @@
  * See COPYING for copyright and distribution information.
  */
 
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "regex-component-matcher.hpp"
 #include "regex-exception.hpp"
+#include "regex-match-trace.hpp"
 
 #include "logging.h"
 
@@ -17,28 +22,123 @@ using namespace std;
 namespace ndn
 {
 
+  static const string CONTAINS_PREFIX = "@contains:";
+
+  static bool
+  isUpperHex(char c)
+  { return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F'); }
+
+  // the characters toEscapedString leaves as they are
+  static bool
+  isUnreserved(char c)
+  { return isalnum(static_cast<unsigned char>(c)) || '+' == c || '-' == c || '.' == c || '_' == c; }
+
   RegexComponentMatcher::RegexComponentMatcher (const string & expr, 
                                                 ptr_lib::shared_ptr<RegexBackrefManager> backRefManager, 
                                                 bool exact)
     : RegexMatcher (expr, EXPR_COMPONENT, backRefManager),
-      m_exact(exact)
+      m_exact(exact),
+      m_literalType(LITERAL_NONE)
   {
     // _LOG_TRACE ("Enter RegexComponentMatcher Constructor: ");
+    parseExpr();
     compile();
     // _LOG_TRACE ("Exit RegexComponentMatcher Constructor: ");
   }
 
+  RegexComponentMatcher::RegexComponentMatcher (const string & expr, 
+                                                ptr_lib::shared_ptr<RegexBackrefManager> backRefManager, 
+                                                bool exact,
+                                                const vector<ptr_lib::shared_ptr<RegexPseudoMatcher> >& pseudoMatchers)
+    : RegexMatcher (expr, EXPR_COMPONENT, backRefManager),
+      m_exact(exact),
+      m_literalType(LITERAL_NONE),
+      m_pseudoMatcher(pseudoMatchers)
+  {
+    parseExpr();
+  }
+
+  bool
+  RegexComponentMatcher::parseContains(const string& expr, string& pattern)
+  {
+    if(0 != expr.compare(0, CONTAINS_PREFIX.size(), CONTAINS_PREFIX))
+      return false;
+
+    pattern = expr.substr(CONTAINS_PREFIX.size());
+    return true;
+  }
+
+  bool
+  RegexComponentMatcher::unescapeLiteral(const string& pattern, string& raw)
+  {
+    raw.clear();
+
+    // components of only dots are escaped differently
+    if(string::npos == pattern.find_first_not_of('.'))
+      return false;
+
+    for(size_t i = 0; i < pattern.size(); i++)
+      {
+        char c = pattern[i];
+        if('%' == c)
+          {
+            // only the escapes toEscapedString produces: upper case, of reserved characters
+            if(i + 2 >= pattern.size() || !isUpperHex(pattern[i + 1]) || !isUpperHex(pattern[i + 2]))
+              return false;
+            char byte = static_cast<char>(strtol(pattern.substr(i + 1, 2).c_str(), NULL, 16));
+            if(isUnreserved(byte))
+              return false;
+            raw.push_back(byte);
+            i += 2;
+          }
+        else if(isalnum(c) || '-' == c || '_' == c)
+          raw.push_back(c);
+        else if('\\' == c && i + 1 < pattern.size() && ('.' == pattern[i + 1] || '+' == pattern[i + 1]))
+          raw.push_back(pattern[++i]);
+        else
+          return false;
+      }
+
+    // a component of only dots is escaped with three more dots
+    return string::npos != raw.find_first_not_of('.');
+  }
+
+  void
+  RegexComponentMatcher::parseExpr()
+  {
+    m_pattern = m_expr;
+
+    if(parseContains(m_expr, m_pattern))
+      {
+        m_exact = false;
+
+        string raw;
+        if(unescapeLiteral(m_pattern, raw))
+          m_searcher = ptr_lib::make_shared<RegexSubstringSearcher>(raw);
+      }
+    else if(RegexComponentPredicate::isPredicate(m_expr))
+      m_predicate = ptr_lib::make_shared<RegexComponentPredicate>(m_expr);
+    else if(m_exact && unescapeLiteral(m_pattern, m_literal))
+      m_literalType = LITERAL_EXACT;
+    else if(m_exact && m_pattern.size() > 2 && 0 == m_pattern.compare(m_pattern.size() - 2, 2, ".*") &&
+            unescapeLiteral(m_pattern.substr(0, m_pattern.size() - 2), m_literal))
+      m_literalType = LITERAL_PREFIX;
+  }
+
   void 
   RegexComponentMatcher::compile ()
   {
     // _LOG_TRACE ("Enter RegexComponentMatcher::compile");
 
-    m_componentRegex = boost::regex (m_expr);
-
     m_pseudoMatcher.clear();
     m_pseudoMatcher.push_back(ptr_lib::make_shared<RegexPseudoMatcher>());
 
-    for (int i = 1; i < m_componentRegex.mark_count(); i++)
+    if(static_cast<bool>(m_predicate) || static_cast<bool>(m_searcher) || LITERAL_NONE != m_literalType)
+      return;
+
+    m_componentRegex = boost::regex (m_pattern);
+
+    for (size_t i = 1; i <= m_componentRegex.mark_count(); i++)
       {
         ptr_lib::shared_ptr<RegexPseudoMatcher> pMatcher = ptr_lib::make_shared<RegexPseudoMatcher>();
         m_pseudoMatcher.push_back(pMatcher);
@@ -50,39 +150,64 @@ namespace ndn
   }
 
   bool
-  RegexComponentMatcher::match (const Name & name, const int & offset, const int & len)
+  RegexComponentMatcher::match (const RegexNameView & name, const int & offset, const int & len)
   {
     // _LOG_TRACE ("Enter RegexComponentMatcher::match ");
+    REGEX_TRACE_MATCH(this);
+
+    if(!isShared())
+      {
+        m_matchResult.clear();
+        m_matchOffset = offset;
+      }
+
+    if(!matchComponent(name, offset))
+      return false;
 
-    m_matchResult.clear();
+    if(!isShared())
+      m_matchResult.push_back(name.get(offset));
+    return true;
+  }
 
+  bool
+  RegexComponentMatcher::matchComponent (const RegexNameView & name, const int & offset)
+  {
     if("" == m_expr)
+      return true;
+
+    if(static_cast<bool>(m_predicate))
+      return m_predicate->match(name.getValue(offset), name.getValueSize(offset));
+
+    if(static_cast<bool>(m_searcher))
+      return 0 != m_searcher->find(name.getValue(offset), name.getValueSize(offset));
+
+    if(LITERAL_NONE != m_literalType)
       {
-        m_matchResult.push_back(name.get(offset));
-        return true;
+        size_t size = name.getValueSize(offset);
+        if(size < m_literal.size() || (LITERAL_EXACT == m_literalType && size != m_literal.size()))
+          return false;
+        return 0 == memcmp(name.getValue(offset), m_literal.c_str(), m_literal.size());
       }
 
-    if(true == m_exact)
+    if(m_componentRegex.empty())
+      m_componentRegex = boost::regex (m_pattern);
+
+    REGEX_TRACE_EVALUATE(this);
+    boost::smatch subResult;
+    string targetStr = name.toEscapedString(offset);
+    bool matched = (m_exact ?
+                    boost::regex_match(targetStr, subResult, m_componentRegex) :
+                    boost::regex_search(targetStr, subResult, m_componentRegex));
+    if(matched)
       {
-        boost::smatch subResult;
-        string targetStr = name.get(offset).toEscapedString();
-        if(boost::regex_match(targetStr, subResult, m_componentRegex))
+        for (size_t i = 1; i <= m_componentRegex.mark_count(); i++)
           {
-            for (int i = 1; i < m_componentRegex.mark_count(); i++)
-              {
-                m_pseudoMatcher[i]->resetMatchResult();
-                m_pseudoMatcher[i]->setMatchResult(subResult[i]);
-              }
-            m_matchResult.push_back(name.get(offset));
-            return true;
+            m_pseudoMatcher[i]->resetMatchResult();
+            m_pseudoMatcher[i]->setMatchResult(subResult[i]);
           }
       }
-    else
-      {
-        throw RegexException("Non-exact component search is not supported yet!");
-      }
 
-    return false;
+    return matched;
   }
 
 } //ndn
@@ -12,6 +12,8 @@
 
 #include "regex-matcher.hpp"
 #include "regex-pseudo-matcher.hpp"
+#include "regex-component-predicate.hpp"
+#include "regex-substring-searcher.hpp"
 
 
 namespace ndn
@@ -21,18 +23,59 @@ namespace ndn
   public:
     /**
      * @brief Create a RegexComponent matcher from expr
-     * @param expr The standard regular expression to match a component
+     * @param expr The standard regular expression to match a component, a typed
+     *             predicate starting with '@' (see RegexComponentPredicate), or
+     *             "@contains:" followed by the expression to search in the component
      * @param backRefManager The back reference manager
      * @param exact The flag to provide exact match
      */
     RegexComponentMatcher(const std::string& expr, 
 			  ptr_lib::shared_ptr<RegexBackrefManager> backRefManager, 
 			  bool exact = true);
+
+    /**
+     * @brief Create a RegexComponent matcher whose regular expression is compiled on first use
+     * @param expr The standard regular expression to match a component
+     * @param backRefManager The back reference manager
+     * @param exact The flag to provide exact match
+     * @param pseudoMatchers The matchers receiving the whole match and the marked sub-expressions,
+     *                       already registered in backRefManager
+     */
+    RegexComponentMatcher(const std::string& expr, 
+			  ptr_lib::shared_ptr<RegexBackrefManager> backRefManager, 
+			  bool exact,
+                          const std::vector<ptr_lib::shared_ptr<RegexPseudoMatcher> >& pseudoMatchers);
     
     virtual ~RegexComponentMatcher() {};
 
     virtual bool 
-    match(const Name & name, const int & offset, const int &len = 1);
+    match(const RegexNameView & name, const int & offset, const int &len = 1);
+
+    bool
+    isExact() const
+    { return m_exact; }
+
+    const std::vector<ptr_lib::shared_ptr<RegexPseudoMatcher> >&
+    getPseudoMatchers() const
+    { return m_pseudoMatcher; }
+
+    /**
+     * @brief split a search expression, "@contains:" followed by the expression to search
+     * @param expr The component expression
+     * @param pattern The expression to search
+     * @returns false if expr is not a search expression
+     */
+    static bool
+    parseContains(const std::string& expr, std::string& pattern);
+
+    /**
+     * @brief convert an expression made only of literal characters (unreserved characters,
+     *        %XX escapes, \. and \+) to the component bytes it matches
+     * @returns false if the expression is not literal, or is not the escaped form of the
+     *          bytes (such as %41 or a component of only dots)
+     */
+    static bool
+    unescapeLiteral(const std::string& pattern, std::string& raw);
 
   protected:
     /**
@@ -43,8 +86,38 @@ namespace ndn
     compile();
     
   private:
+    /**
+     * @brief test the component at offset, setting the marked sub-expressions if any
+     */
+    bool
+    matchComponent(const RegexNameView & name, const int & offset);
+
+    /**
+     * @brief set up a typed predicate, a literal or a literal search, which do not need
+     *        m_componentRegex.
+     *
+     * A literal search looks for the bytes of the literal in the component value, and a
+     * literal ("ksk-1") or literal prefix ("ksk-.*") is compared with its bytes; any other
+     * expression is matched by boost::regex on the escaped component, which also fills the
+     * captures.
+     */
+    void
+    parseExpr();
+
+  private:
+    enum LiteralType {
+      LITERAL_NONE,
+      LITERAL_EXACT,
+      LITERAL_PREFIX
+    };
+
     bool m_exact;
+    std::string m_pattern;
+    LiteralType m_literalType;
+    std::string m_literal;
     boost::regex m_componentRegex;
+    ptr_lib::shared_ptr<RegexComponentPredicate> m_predicate;
+    ptr_lib::shared_ptr<RegexSubstringSearcher> m_searcher;
     std::vector<ptr_lib::shared_ptr<RegexPseudoMatcher> > m_pseudoMatcher;
     
   };
@@ -0,0 +1,131 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <limits>
+
+#include "regex-component-predicate.hpp"
+#include "regex-exception.hpp"
+
+#include "logging.h"
+
+INIT_LOGGER ("RegexComponentPredicate");
+
+using namespace std;
+
+namespace ndn
+{
+  static const uint8_t SEGMENT_MARKER = 0x00;
+  static const uint8_t TIMESTAMP_MARKER = 0xFC;
+  static const uint8_t VERSION_MARKER = 0xFD;
+
+  RegexComponentPredicate::RegexComponentPredicate(const string& expr)
+    : m_min(0),
+      m_max(numeric_limits<uint64_t>::max())
+  {
+    string errMsg = "Error: RegexComponentPredicate: ";
+
+    if(!isPredicate(expr))
+      throw RegexException(errMsg + "not a predicate " + expr);
+
+    size_t separator = expr.find(':');
+    string type = expr.substr(1, separator - 1);
+    if("seg" == type)
+      m_type = SEGMENT;
+    else if("ver" == type)
+      m_type = VERSION;
+    else if("ts" == type)
+      m_type = TIMESTAMP;
+    else if("num" == type)
+      m_type = NUMBER;
+    else
+      throw RegexException(errMsg + "unknown predicate " + expr);
+
+    if(string::npos == separator)
+      return;
+
+    string range = expr.substr(separator + 1);
+    size_t dash = range.find('-');
+    if(string::npos == dash)
+      {
+        m_min = parseNumber(expr, range);
+        m_max = m_min;
+      }
+    else
+      {
+        if(0 == dash && 1 == range.size())
+          throw RegexException(errMsg + "empty range " + expr);
+        if(dash > 0)
+          m_min = parseNumber(expr, range.substr(0, dash));
+        if(dash + 1 < range.size())
+          m_max = parseNumber(expr, range.substr(dash + 1));
+      }
+
+    if(m_min > m_max)
+      throw RegexException(errMsg + "wrong range " + expr);
+  }
+
+  uint64_t
+  RegexComponentPredicate::parseNumber(const string& expr, const string& str)
+  {
+    if(str.empty() || str.size() > 20)
+      throw RegexException("Error: RegexComponentPredicate: wrong number " + expr);
+
+    uint64_t number = 0;
+    for(size_t i = 0; i < str.size(); i++)
+      {
+        if(str[i] < '0' || str[i] > '9')
+          throw RegexException("Error: RegexComponentPredicate: wrong number " + expr);
+
+        uint64_t digit = str[i] - '0';
+        if(number > (numeric_limits<uint64_t>::max() - digit) / 10)
+          throw RegexException("Error: RegexComponentPredicate: wrong number " + expr);
+        number = number * 10 + digit;
+      }
+    return number;
+  }
+
+  bool
+  RegexComponentPredicate::match(const uint8_t* value, size_t size) const
+  {
+    const uint8_t* begin = value;
+    const uint8_t* end = value + size;
+
+    switch(m_type){
+    case SEGMENT:
+      if(0 == size || SEGMENT_MARKER != *begin)
+        return false;
+      begin++;
+      break;
+    case VERSION:
+      if(0 == size || VERSION_MARKER != *begin)
+        return false;
+      begin++;
+      break;
+    case TIMESTAMP:
+      if(0 == size || TIMESTAMP_MARKER != *begin)
+        return false;
+      begin++;
+      break;
+    case NUMBER:
+      // a number without marker must have at least one byte
+      if(0 == size)
+        return false;
+      break;
+    }
+
+    if(end - begin > 8)
+      return false;
+
+    // a marker alone stands for 0, as the first segment "%00"
+    uint64_t number = 0;
+    for(; begin != end; begin++)
+      number = (number << 8) | *begin;
+
+    return number >= m_min && number <= m_max;
+  }
+
+}//ndn
@@ -0,0 +1,72 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_REGEX_COMPONENT_PREDICATE_H
+#define NDN_REGEX_COMPONENT_PREDICATE_H
+
+#include <string>
+#include <stdint.h>
+
+namespace ndn
+{
+  /**
+   * @brief A typed test of a component, written in place of a component regex.
+   *
+   *   <@seg>  <@seg:lo-hi>   segment number, marker 0x00
+   *   <@ver>  <@ver:lo-hi>   version, marker 0xFD
+   *   <@ts>   <@ts:lo-hi>    timestamp, marker 0xFC
+   *   <@num>  <@num:lo-hi>   plain non-negative integer of 1 to 8 bytes
+   *
+   * The integer follows the marker in big-endian order.  A range can be open on either
+   * side ("lo-", "-hi") or a single number, bounds are inclusive.  '@' is always escaped
+   * in a component's text, so these never collide with a component regex.
+   */
+  class RegexComponentPredicate
+  {
+  public:
+    enum Type {
+      SEGMENT,
+      VERSION,
+      TIMESTAMP,
+      NUMBER
+    };
+
+    /**
+     * @brief Parse a predicate
+     * @param expr The predicate, starting with '@'
+     * @throws RegexException if expr is not a valid predicate
+     */
+    RegexComponentPredicate(const std::string& expr);
+
+    static bool
+    isPredicate(const std::string& expr)
+    { return !expr.empty() && '@' == expr[0]; }
+
+    /**
+     * @brief test the value of a component
+     * @returns true if the component has the marker and a number within the range
+     */
+    bool
+    match(const uint8_t* value, size_t size) const;
+
+    Type
+    getType() const
+    { return m_type; }
+
+  private:
+    static uint64_t
+    parseNumber(const std::string& expr, const std::string& str);
+
+  private:
+    Type m_type;
+    uint64_t m_min;
+    uint64_t m_max;
+  };
+
+}//ndn
+
+#endif
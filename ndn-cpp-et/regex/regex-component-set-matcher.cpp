@@ -7,6 +7,7 @@
 
 #include "regex-component-set-matcher.hpp"
 #include "regex-exception.hpp"
+#include "regex-match-trace.hpp"
 
 #include "logging.h"
 
@@ -25,6 +26,15 @@ namespace ndn
     // _LOG_TRACE ("Exit RegexComponentSetMatcher Constructor");
   }
 
+  RegexComponentSetMatcher::RegexComponentSetMatcher(const string expr, 
+                                                     ptr_lib::shared_ptr<RegexBackrefManager> backRefManager,
+                                                     bool include,
+                                                     const set<ptr_lib::shared_ptr<RegexComponentMatcher> >& components)
+    : RegexMatcher(expr, EXPR_COMPONENT_SET, backRefManager),
+      m_components(components),
+      m_include(include)
+  {}
+
   RegexComponentSetMatcher::~RegexComponentSetMatcher()
   {
     // set<Ptr<RegexComponent> >::iterator it = m_components.begin();
@@ -115,9 +125,10 @@ namespace ndn
   }
 
   bool 
-  RegexComponentSetMatcher::match(const Name & name, const int & offset, const int & len)
+  RegexComponentSetMatcher::match(const RegexNameView & name, const int & offset, const int & len)
   {
     // _LOG_TRACE ("Enter RegexComponentSetMatcher::match");
+    REGEX_TRACE_MATCH(this);
 
     bool matched = false;
 
@@ -136,7 +147,11 @@ namespace ndn
       }
     }
     
+    if(isShared())
+      return m_include ? matched : !matched;
+
     m_matchResult.clear();
+    m_matchOffset = offset;
 
     if(m_include ? matched : !matched){
       m_matchResult.push_back(name.get(offset));
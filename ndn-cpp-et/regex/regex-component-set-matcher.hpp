@@ -28,10 +28,33 @@ namespace ndn
      */
     RegexComponentSetMatcher(const std::string expr, ptr_lib::shared_ptr<RegexBackrefManager> backRefManager);    
 
+    /**
+     * @brief Create a RegexComponentSetMatcher from already compiled component matchers
+     * @param expr The expression the components were compiled from
+     * @param backRefManager The back reference manager
+     * @param include false if the set is exclusive ([^...])
+     * @param components The compiled component matchers
+     */
+    RegexComponentSetMatcher(const std::string expr, 
+                             ptr_lib::shared_ptr<RegexBackrefManager> backRefManager,
+                             bool include,
+                             const std::set<ptr_lib::shared_ptr<RegexComponentMatcher> >& components);
+
     virtual ~RegexComponentSetMatcher();
 
     virtual bool 
-    match(const Name & name, const int & offset, const int & len = 1);
+    match(const RegexNameView & name, const int & offset, const int & len = 1);
+
+    /**
+     * @brief check if the set is inclusive ([<a><b>]) or exclusive ([^<a><b>])
+     */
+    bool
+    isInclusive() const
+    { return m_include; }
+
+    const std::set<ptr_lib::shared_ptr<RegexComponentMatcher> >&
+    getComponents() const
+    { return m_components; }
 
   protected:    
     /**
@@ -0,0 +1,65 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <stdlib.h>
+
+#include "regex-expand-pattern.hpp"
+#include "regex-exception.hpp"
+
+#include "logging.h"
+
+INIT_LOGGER ("RegexExpandPattern");
+
+using namespace std;
+
+namespace ndn
+{
+  RegexExpandPattern::RegexExpandPattern(const string& expand)
+  {
+    size_t offset = 0;
+    while(offset < expand.size())
+      {
+        size_t begin = offset;
+        Item item;
+
+        if('\\' == expand[offset])
+          {
+            offset++;
+            while(offset < expand.size() && expand[offset] <= '9' && expand[offset] >= '0')
+              offset++;
+            if(offset == begin + 1)
+              throw RegexException("wrong format of expand string!");
+
+            item.m_backRef = atoi(expand.substr(begin + 1, offset - begin - 1).c_str());
+          }
+        else if('<' == expand[offset])
+          {
+            offset++;
+            int left = 1;
+            int right = 0;
+            while(right < left)
+              {
+                if(offset >= expand.size())
+                  throw RegexException("wrong format of expand string!");
+                if('<' == expand[offset])
+                  left++;
+                if('>' == expand[offset])
+                  right++;
+                offset++;
+              }
+
+            item.m_backRef = -1;
+            item.m_value = expand.substr(begin + 1, offset - begin - 2);
+          }
+        else
+          throw RegexException("wrong format of expand string!");
+
+        m_items.push_back(item);
+      }
+  }
+
+}//ndn
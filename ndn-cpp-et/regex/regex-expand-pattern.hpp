@@ -0,0 +1,78 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_REGEX_EXPAND_PATTERN_H
+#define NDN_REGEX_EXPAND_PATTERN_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace ndn
+{
+  /**
+   * @brief A parsed expand string, such as "<ndn>\1\2".
+   *
+   * The string is parsed once into literal components and back references, which
+   * RegexTopMatcher::expand resolves against the last match.  Expanding into a ValueList
+   * gives the values of the components in place, without building a Name.
+   */
+  class RegexExpandPattern
+  {
+  public:
+    /**
+     * @brief The values of expanded components, as pointer and size
+     */
+    typedef std::vector<std::pair<const uint8_t*, size_t> > ValueList;
+
+    /**
+     * @brief parse an expand string
+     * @param expand The expand string
+     * @throws RegexException if the expand string is malformed
+     */
+    RegexExpandPattern(const std::string& expand);
+
+    size_t
+    size() const
+    { return m_items.size(); }
+
+    /**
+     * @brief check if an item is a back reference, or else a literal component
+     */
+    bool
+    isBackRef(size_t index) const
+    { return m_items[index].m_backRef >= 0; }
+
+    /**
+     * @brief get the back reference of an item, 0 stands for the whole match
+     */
+    int
+    getBackRef(size_t index) const
+    { return m_items[index].m_backRef; }
+
+    /**
+     * @brief get the value of a literal component
+     */
+    const std::string&
+    getValue(size_t index) const
+    { return m_items[index].m_value; }
+
+  private:
+    struct Item
+    {
+      int m_backRef;
+      std::string m_value;
+    };
+
+  private:
+    std::vector<Item> m_items;
+  };
+
+}//ndn
+
+#endif
@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <string.h>
+
+#include "regex-literal-matcher.hpp"
+
+#include "logging.h"
+
+INIT_LOGGER ("RegexLiteralMatcher");
+
+using namespace std;
+
+namespace ndn
+{
+  RegexLiteralMatcher::RegexLiteralMatcher(const Name& prefix, bool hasAnchor)
+    : RegexTopMatcher(toExpr(prefix, hasAnchor), "",
+                      ptr_lib::shared_ptr<RegexPatternListMatcher>(), ptr_lib::make_shared<RegexBackrefManager>(),
+                      ptr_lib::shared_ptr<RegexPatternListMatcher>(), ptr_lib::make_shared<RegexBackrefManager>()),
+      m_prefix(prefix),
+      m_hasAnchor(hasAnchor)
+  {}
+
+  RegexLiteralMatcher::~RegexLiteralMatcher()
+  {}
+
+  bool
+  RegexLiteralMatcher::match(const RegexNameView & name)
+  {
+    REGEX_TRACE_MATCH(this);
+    resetMatchResult();
+
+    if(name.size() < m_prefix.size() || (m_hasAnchor && name.size() != m_prefix.size()))
+      return false;
+
+    for(size_t i = 0; i < m_prefix.size(); i++)
+      {
+        const Name::Component& component = m_prefix.get(i);
+        if(component.value_size() != name.getValueSize(i) ||
+           0 != memcmp(component.value(), name.getValue(i), component.value_size()))
+          return false;
+      }
+
+    // the prefix is followed by <.*>*, so the whole name is matched
+    m_matchResult.reserve(name.size());
+    for(size_t i = 0; i < name.size(); i++)
+      m_matchResult.push_back(name.get(i));
+
+    return true;
+  }
+
+  string
+  RegexLiteralMatcher::toExpr(const Name& prefix, bool hasAnchor)
+  {
+    string regexStr("^");
+
+    Name::const_iterator it = prefix.begin();
+    for(; it != prefix.end(); it++)
+      {
+        regexStr.append("<");
+        regexStr.append(convertSpecialChar(it->toEscapedString()));
+        regexStr.append(">");
+      }
+
+    if(hasAnchor)
+      regexStr.append("$");
+
+    return regexStr;
+  }
+
+}//ndn
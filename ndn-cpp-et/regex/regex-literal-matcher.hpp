@@ -0,0 +1,58 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_REGEX_LITERAL_MATCHER_H
+#define NDN_REGEX_LITERAL_MATCHER_H
+
+#include "regex-top-matcher.hpp"
+
+namespace ndn
+{
+  /**
+   * @brief A RegexTopMatcher of a literal name prefix, as created by RegexTopMatcher::fromName.
+   *
+   * Components are compared byte by byte, no matcher tree is built.  The expression
+   * (getExpr()) is still the equivalent regex, e.g. "^<ndn><ucla\.edu>" for /ndn/ucla.edu.
+   */
+  class RegexLiteralMatcher : public RegexTopMatcher
+  {
+  public:
+    /**
+     * @brief Create a RegexLiteralMatcher
+     * @param prefix The prefix to match
+     * @param hasAnchor true if the whole name must be equal to the prefix
+     */
+    RegexLiteralMatcher(const Name& prefix, bool hasAnchor = false);
+
+    virtual
+    ~RegexLiteralMatcher();
+
+    using RegexTopMatcher::match;
+
+    virtual bool
+    match(const RegexNameView & name);
+
+    const Name&
+    getPrefix() const
+    { return m_prefix; }
+
+    bool
+    hasAnchor() const
+    { return m_hasAnchor; }
+
+  private:
+    static std::string
+    toExpr(const Name& prefix, bool hasAnchor);
+
+  private:
+    const Name m_prefix;
+    const bool m_hasAnchor;
+  };
+
+}//ndn
+
+#endif
@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <algorithm>
+
+#include "regex-match-memo.hpp"
+#include "regex-subpattern-table.hpp"
+
+#include "logging.h"
+
+INIT_LOGGER ("RegexMatchMemo");
+
+using namespace std;
+
+namespace ndn
+{
+  static const int8_t UNKNOWN = -1;
+  static const size_t NO_TABLE = static_cast<size_t>(-1);
+
+  RegexMatchMemo::RegexMatchMemo(size_t nameSize)
+    : m_nameSize(nameSize),
+      m_hitCount(0)
+  {}
+
+  void
+  RegexMatchMemo::reset(size_t nameSize)
+  {
+    vector<size_t>::const_iterator it = m_usedIds.begin();
+    for(; it != m_usedIds.end(); it++)
+      m_tables[*it] = NO_TABLE;
+
+    m_usedIds.clear();
+    m_results.clear();
+    m_nameSize = nameSize;
+    m_hitCount = 0;
+  }
+
+  int
+  RegexMatchMemo::find(const RegexMatcher* matcher, size_t offset, size_t len)
+  {
+    size_t memoId = matcher->getMemoId();
+    if(offset + len > m_nameSize || memoId >= m_tables.size() || NO_TABLE == m_tables[memoId])
+      return UNKNOWN;
+
+    // results are indexed by (offset, len), both in [0, m_nameSize]
+    int8_t result = m_results[m_tables[memoId] + offset * (m_nameSize + 1) + len];
+    if(UNKNOWN != result)
+      m_hitCount++;
+    return result;
+  }
+
+  void
+  RegexMatchMemo::insert(const RegexMatcher* matcher, size_t offset, size_t len, bool matched)
+  {
+    size_t memoId = matcher->getMemoId();
+    if(offset + len > m_nameSize || RegexMatcher::NO_MEMO_ID == memoId)
+      return;
+
+    if(memoId >= m_tables.size())
+      m_tables.resize(max(memoId + 1, RegexSubpatternTable::getMemoIdCount()), NO_TABLE);
+
+    if(NO_TABLE == m_tables[memoId])
+      {
+        m_tables[memoId] = m_results.size();
+        m_usedIds.push_back(memoId);
+        m_results.resize(m_results.size() + (m_nameSize + 1) * (m_nameSize + 1), UNKNOWN);
+      }
+    m_results[m_tables[memoId] + offset * (m_nameSize + 1) + len] = (matched ? 1 : 0);
+  }
+
+}//ndn
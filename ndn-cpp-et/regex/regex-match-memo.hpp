@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_REGEX_MATCH_MEMO_H
+#define NDN_REGEX_MATCH_MEMO_H
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ndn
+{
+  class RegexMatcher;
+
+  /**
+   * @brief Results of shared sub-pattern matchers on one name.
+   *
+   * A matcher shared through RegexSubpatternTable has no captures, so whether it matches
+   * a range of the name depends only on the range.  Attaching a memo to a RegexNameView
+   * (RegexNameView::setMemo) lets every expression matched against the view reuse the
+   * results of the sub-patterns it shares with the others.  A memo belongs to one name
+   * at a time, reset() moves it to the next one.
+   *
+   * The results of a sub-pattern are a table of (nameSize + 1)^2 entries in one flat
+   * buffer, found through the memo id of the sub-pattern (RegexMatcher::getMemoId).  A
+   * memo reset for names no longer than the ones it has seen does not allocate.
+   */
+  class RegexMatchMemo
+  {
+  public:
+    /**
+     * @param nameSize The number of components of the name
+     */
+    RegexMatchMemo(size_t nameSize = 0);
+
+    /**
+     * @brief forget the recorded results and move to another name, keeping the storage
+     * @param nameSize The number of components of the name
+     */
+    void
+    reset(size_t nameSize);
+
+    /**
+     * @brief find the recorded result of a matcher on the components [offset, offset + len)
+     * @returns 1 if it matched, 0 if it did not, -1 if no result is recorded
+     */
+    int
+    find(const RegexMatcher* matcher, size_t offset, size_t len);
+
+    void
+    insert(const RegexMatcher* matcher, size_t offset, size_t len, bool matched);
+
+    /**
+     * @brief get the number of results found by find()
+     */
+    size_t
+    getHitCount() const
+    { return m_hitCount; }
+
+  private:
+    size_t m_nameSize;
+    // by memo id, the position of the results of the sub-pattern in m_results, or NO_TABLE
+    std::vector<size_t> m_tables;
+    std::vector<size_t> m_usedIds;
+    std::vector<int8_t> m_results;
+    size_t m_hitCount;
+  };
+
+}//ndn
+
+#endif
@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include <boost/thread/tss.hpp>
+
+#include "regex-match-trace.hpp"
+#include "regex-top-matcher.hpp"
+
+#include "logging.h"
+
+INIT_LOGGER ("RegexMatchTrace");
+
+using namespace std;
+
+namespace ndn
+{
+  // the trace is not owned by the thread, nothing to delete when the thread exits
+  static void
+  keepTrace(RegexMatchTrace* trace)
+  {}
+
+  static boost::thread_specific_ptr<RegexMatchTrace>&
+  getCurrentTrace()
+  {
+    static boost::thread_specific_ptr<RegexMatchTrace> currentTrace(&keepTrace);
+    return currentTrace;
+  }
+
+  static bool
+  compareInvocations(const RegexMatchTrace::Counter* a, const RegexMatchTrace::Counter* b)
+  { return a->m_invocations > b->m_invocations; }
+
+  RegexMatchTrace::Frame::Frame(const RegexMatcher* matcher, bool isInvocation)
+    : m_trace(getCurrentTrace().get())
+  {
+    if(0 == m_trace)
+      return;
+
+    if(isInvocation)
+      {
+        m_trace->getCounter(matcher).m_invocations++;
+        m_trace->m_total.m_invocations++;
+      }
+    m_trace->m_depth++;
+    m_trace->m_maxDepth = max(m_trace->m_maxDepth, m_trace->m_depth);
+  }
+
+  RegexMatchTrace::Frame::~Frame()
+  {
+    if(0 != m_trace)
+      m_trace->m_depth--;
+  }
+
+  RegexMatchTrace::RegexMatchTrace()
+    : m_native(false),
+      m_matched(false),
+      m_depth(0),
+      m_maxDepth(0)
+  {}
+
+  bool
+  RegexMatchTrace::isEnabled()
+  {
+#ifdef NDN_REGEX_TRACE
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  void
+  RegexMatchTrace::onBacktrack(const RegexMatcher* matcher)
+  {
+    RegexMatchTrace* trace = getCurrentTrace().get();
+    if(0 == trace)
+      return;
+
+    trace->getCounter(matcher).m_backtracks++;
+    trace->m_total.m_backtracks++;
+  }
+
+  void
+  RegexMatchTrace::onEvaluate(const RegexMatcher* matcher)
+  {
+    RegexMatchTrace* trace = getCurrentTrace().get();
+    if(0 == trace)
+      return;
+
+    trace->getCounter(matcher).m_evaluations++;
+    trace->m_total.m_evaluations++;
+  }
+
+  void
+  RegexMatchTrace::start(const RegexTopMatcher& matcher)
+  {
+    m_expr = matcher.getExpr();
+    m_native = matcher.isNative();
+    m_matched = false;
+    m_total = Counter();
+    m_depth = 0;
+    m_maxDepth = 0;
+    m_counters.clear();
+
+    getCurrentTrace().reset(this);
+  }
+
+  void
+  RegexMatchTrace::finish(bool matched)
+  {
+    getCurrentTrace().reset();
+    m_matched = matched;
+  }
+
+  RegexMatchTrace::Counter&
+  RegexMatchTrace::getCounter(const RegexMatcher* matcher)
+  {
+    Counter& counter = m_counters[matcher];
+    if(counter.m_expr.empty())
+      counter.m_expr = matcher->getExpr();
+    return counter;
+  }
+
+  void
+  RegexMatchTrace::print(ostream& os) const
+  {
+    os << m_expr << (m_matched ? " matched" : " not matched") << (m_native ? " (native)" : "")
+       << ": " << m_total.m_invocations << " invocations, "
+       << m_total.m_backtracks << " backtracks, "
+       << m_total.m_evaluations << " evaluations, depth " << m_maxDepth << endl;
+
+    vector<const Counter*> counters;
+    for(CounterMap::const_iterator it = m_counters.begin(); it != m_counters.end(); it++)
+      counters.push_back(&it->second);
+    stable_sort(counters.begin(), counters.end(), compareInvocations);
+
+    for(vector<const Counter*>::const_iterator it = counters.begin(); it != counters.end(); it++)
+      {
+        os << "  " << (*it)->m_invocations << "/" << (*it)->m_backtracks << "/" << (*it)->m_evaluations
+           << " " << (*it)->m_expr << endl;
+      }
+  }
+
+}//ndn
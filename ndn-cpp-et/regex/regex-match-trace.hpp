@@ -0,0 +1,166 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_REGEX_MATCH_TRACE_H
+#define NDN_REGEX_MATCH_TRACE_H
+
+#include <map>
+#include <ostream>
+#include <string>
+
+namespace ndn
+{
+  class RegexMatcher;
+  class RegexTopMatcher;
+
+  /**
+   * @brief Counters of one RegexTopMatcher::match, see RegexTopMatcher::match(name, trace).
+   *
+   * The matchers are only instrumented when the library is built with NDN_REGEX_TRACE
+   * (./waf configure --regex-trace); otherwise the counters stay at 0 and the hooks
+   * compile to nothing.
+   */
+  class RegexMatchTrace
+  {
+  public:
+    struct Counter
+    {
+      Counter()
+        : m_invocations(0),
+          m_backtracks(0),
+          m_evaluations(0)
+      {}
+
+      std::string m_expr;
+      size_t m_invocations;
+      size_t m_backtracks;
+      size_t m_evaluations;
+    };
+
+    typedef std::map<const RegexMatcher*, Counter> CounterMap;
+
+    /**
+     * @brief Depth and invocation counting of a matcher frame, used by the REGEX_TRACE macros
+     */
+    class Frame
+    {
+    public:
+      Frame(const RegexMatcher* matcher, bool isInvocation);
+
+      ~Frame();
+
+    private:
+      RegexMatchTrace* m_trace;
+    };
+
+    RegexMatchTrace();
+
+    /**
+     * @brief check if the library is built with NDN_REGEX_TRACE
+     */
+    static bool
+    isEnabled();
+
+    const std::string&
+    getExpr() const
+    { return m_expr; }
+
+    bool
+    isMatched() const
+    { return m_matched; }
+
+    /**
+     * @brief get the number of match() calls of all the matchers, the top matcher included
+     */
+    size_t
+    getInvocations() const
+    { return m_total.m_invocations; }
+
+    /**
+     * @brief get the number of splits of the name retried after a failed one
+     */
+    size_t
+    getBacktracks() const
+    { return m_total.m_backtracks; }
+
+    /**
+     * @brief get the number of component regular expressions evaluated
+     */
+    size_t
+    getEvaluations() const
+    { return m_total.m_evaluations; }
+
+    /**
+     * @brief get the deepest nesting of matcher calls and recursive matches
+     */
+    size_t
+    getMaxDepth() const
+    { return m_maxDepth; }
+
+    const CounterMap&
+    getCounters() const
+    { return m_counters; }
+
+    /**
+     * @brief print a summary line, then a line per matcher in decreasing number of invocations
+     */
+    void
+    print(std::ostream& os) const;
+
+    static void
+    onBacktrack(const RegexMatcher* matcher);
+
+    static void
+    onEvaluate(const RegexMatcher* matcher);
+
+  private:
+    friend class RegexTopMatcher;
+
+    /**
+     * @brief reset the counters and trace the matches of this thread until finish()
+     */
+    void
+    start(const RegexTopMatcher& matcher);
+
+    void
+    finish(bool matched);
+
+    Counter&
+    getCounter(const RegexMatcher* matcher);
+
+  private:
+    std::string m_expr;
+    bool m_native;
+    bool m_matched;
+    Counter m_total;
+    size_t m_depth;
+    size_t m_maxDepth;
+    CounterMap m_counters;
+  };
+
+  inline std::ostream&
+  operator<<(std::ostream& os, const RegexMatchTrace& trace)
+  {
+    trace.print(os);
+    return os;
+  }
+
+}//ndn
+
+#ifdef NDN_REGEX_TRACE
+#define REGEX_TRACE_MATCH(matcher) ndn::RegexMatchTrace::Frame regexTraceFrame(matcher, true)
+#define REGEX_TRACE_RECURSE(matcher) ndn::RegexMatchTrace::Frame regexTraceFrame(matcher, false)
+#define REGEX_TRACE_BACKTRACK(matcher) ndn::RegexMatchTrace::onBacktrack(matcher)
+#define REGEX_TRACE_EVALUATE(matcher) ndn::RegexMatchTrace::onEvaluate(matcher)
+#else
+#define REGEX_TRACE_MATCH(matcher)
+#define REGEX_TRACE_RECURSE(matcher)
+#define REGEX_TRACE_BACKTRACK(matcher)
+#define REGEX_TRACE_EVALUATE(matcher)
+#endif
+
+#endif
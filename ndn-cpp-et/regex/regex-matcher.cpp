@@ -7,6 +7,8 @@
 
 #include "regex-matcher.hpp"
 #include "regex-exception.hpp"
+#include "regex-match-trace.hpp"
+#include "regex-subpattern-table.hpp"
 
 #include "logging.h"
 
@@ -16,27 +18,37 @@ using namespace std;
 
 namespace ndn
 {
+  const size_t RegexMatcher::NO_MEMO_ID = static_cast<size_t>(-1);
+
   RegexMatcher::RegexMatcher(const std::string& expr, 
 			     const RegexExprType& type,  
 			     ptr_lib::shared_ptr<RegexBackrefManager> backrefManager) 
     : m_expr(expr), 
       m_type(type),
-      m_backrefManager(backrefManager)
+      m_backrefManager(backrefManager),
+      m_matchOffset(0),
+      m_shared(false),
+      m_memoId(NO_MEMO_ID)
   {
     if(NULL == m_backrefManager)
       m_backrefManager = ptr_lib::shared_ptr<RegexBackrefManager>(new RegexBackrefManager);
   }
 
   RegexMatcher::~RegexMatcher()
-  {}
+  {
+    if(NO_MEMO_ID != m_memoId)
+      RegexSubpatternTable::releaseMemoId(m_memoId);
+  }
 
   bool 
-  RegexMatcher::match (const Name& name, const int& offset, const int& len)
+  RegexMatcher::match (const RegexNameView& name, const int& offset, const int& len)
   {
     // _LOG_TRACE ("Enter RegexMatcher::match");
+    REGEX_TRACE_MATCH(this);
     bool result = false;
 
     m_matchResult.clear();
+    m_matchOffset = offset;
 
     if(recursiveMatch(0, name, offset, len))
       {
@@ -54,9 +66,10 @@ namespace ndn
   }
   
   bool 
-  RegexMatcher::recursiveMatch(const int& mId, const Name& name, const int& offset, const int& len)
+  RegexMatcher::recursiveMatch(const int& mId, const RegexNameView & name, const int& offset, const int& len)
   {
     // _LOG_TRACE ("Enter RegexMatcher::recursiveMatch");
+    REGEX_TRACE_RECURSE(this);
 
     int tried = len;
 
@@ -69,6 +82,7 @@ namespace ndn
       {
 	if(matcher->match(name, offset, tried) && recursiveMatch(mId + 1, name, offset + tried, len - tried))
 	  return true;      
+	REGEX_TRACE_BACKTRACK(this);
 	tried--;
       }
 
@@ -12,6 +12,7 @@
 #include <string>
 #include <ndn-cpp-dev/name.hpp>
 #include "regex-backref-manager.hpp"
+#include "regex-name-view.hpp"
 
 namespace ndn
 {
@@ -43,7 +44,7 @@ namespace ndn
     ~RegexMatcher();
 
     virtual bool 
-    match(const Name& name, const int& offset, const int& len);
+    match(const RegexNameView& name, const int& offset, const int& len);
 
     /**
      * @brief get the matched name components
@@ -53,10 +54,54 @@ namespace ndn
     getMatchResult() const
     { return m_matchResult; }
 
+    /**
+     * @brief get the offset in the name of the first component of getMatchResult()
+     */
+    int
+    getMatchOffset() const
+    { return m_matchOffset; }
+
+    void
+    resetMatchResult()
+    {
+      m_matchResult.clear();
+      m_matchOffset = 0;
+    }
+
     const std::string&
     getExpr() const
     { return m_expr; } 
 
+    const RegexExprType&
+    getType() const
+    { return m_type; }
+
+    /**
+     * @brief get the sub-matchers generated by compile()
+     * @returns the sub-matchers in the order they are matched
+     */
+    const std::vector<ptr_lib::shared_ptr<RegexMatcher> >&
+    getMatcherList() const
+    { return m_matcherList; }
+
+    /**
+     * @brief check if the matcher is shared by several expressions (see RegexSubpatternTable),
+     *        a shared matcher keeps no match result
+     */
+    bool
+    isShared() const
+    { return m_shared; }
+
+    /**
+     * @brief get the index of the results of a shared sub-pattern in a RegexMatchMemo
+     * @returns the index, or NO_MEMO_ID if the results of the matcher are not memoized
+     */
+    size_t
+    getMemoId() const
+    { return m_memoId; }
+
+    static const size_t NO_MEMO_ID;
+
   protected:
     /**
      * @brief Compile the regular expression to generate the more matchers when necessary
@@ -67,7 +112,7 @@ namespace ndn
 
   private:
     bool 
-    recursiveMatch(const int& mId, const Name& name, const int& offset, const int& len);
+    recursiveMatch(const int& mId, const RegexNameView & name, const int& offset, const int& len);
 
 
   protected:
@@ -76,7 +121,12 @@ namespace ndn
     ptr_lib::shared_ptr<RegexBackrefManager> m_backrefManager;
     std::vector<ptr_lib::shared_ptr<RegexMatcher> > m_matcherList;
     std::vector<Name::Component> m_matchResult;
+    int m_matchOffset;
 
+  private:
+    friend class RegexSubpatternTable;
+    bool m_shared;
+    size_t m_memoId;
   };
 }//ndn
 
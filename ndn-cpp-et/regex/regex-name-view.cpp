@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <stdio.h>
+#include <ndn-cpp-dev/encoding/tlv.hpp>
+
+#include "regex-name-view.hpp"
+#include "regex-exception.hpp"
+
+#include "logging.h"
+
+INIT_LOGGER ("RegexNameView");
+
+using namespace std;
+
+namespace ndn
+{
+  RegexNameView::RegexNameView(const Name& name)
+    : m_name(&name),
+      m_values(&m_ownValues),
+      m_memo(0)
+  {}
+
+  RegexNameView::RegexNameView(const Block& wire)
+    : m_name(0),
+      m_values(&m_ownValues),
+      m_memo(0)
+  {
+    if(!wire.hasWire())
+      throw RegexException("RegexNameView: Name TLV is not encoded");
+
+    parseWire(wire.wire(), wire.size());
+  }
+
+  RegexNameView::RegexNameView(const Block& wire, ValueList& values)
+    : m_name(0),
+      m_values(&values),
+      m_memo(0)
+  {
+    if(!wire.hasWire())
+      throw RegexException("RegexNameView: Name TLV is not encoded");
+
+    parseWire(wire.wire(), wire.size());
+  }
+
+  RegexNameView::RegexNameView(const uint8_t* wire, size_t size)
+    : m_name(0),
+      m_values(&m_ownValues),
+      m_memo(0)
+  {
+    parseWire(wire, size);
+  }
+
+  RegexNameView::RegexNameView(const uint8_t* wire, size_t size, ValueList& values)
+    : m_name(0),
+      m_values(&values),
+      m_memo(0)
+  {
+    parseWire(wire, size);
+  }
+
+  RegexNameView::RegexNameView(const RegexNameView& other)
+    : m_name(other.m_name),
+      m_values(&other.m_ownValues == other.m_values ? &m_ownValues : other.m_values),
+      m_ownValues(other.m_ownValues),
+      m_memo(other.m_memo)
+  {}
+
+  void
+  RegexNameView::parseWire(const uint8_t* wire, size_t size)
+  {
+    m_values->clear();
+
+    const uint8_t* begin = wire;
+    const uint8_t* end = wire + size;
+    try{
+      if(Tlv::Name != Tlv::readType(begin, end))
+        throw RegexException("RegexNameView: not a Name TLV");
+
+      uint64_t length = Tlv::readVarNumber(begin, end);
+      if(length != static_cast<uint64_t>(end - begin))
+        throw RegexException("RegexNameView: wrong length of Name TLV");
+
+      while(begin != end)
+        {
+          Tlv::readType(begin, end);
+          uint64_t valueSize = Tlv::readVarNumber(begin, end);
+          if(valueSize > static_cast<uint64_t>(end - begin))
+            throw RegexException("RegexNameView: wrong length of name component");
+
+          m_values->push_back(make_pair(begin, static_cast<size_t>(valueSize)));
+          begin += valueSize;
+        }
+    }catch(Tlv::Error& e){
+      throw RegexException(string("RegexNameView: ") + e.what());
+    }
+  }
+
+  Name::Component
+  RegexNameView::get(size_t index) const
+  {
+    if(0 != m_name)
+      return m_name->get(index);
+    else
+      return Name::Component((*m_values)[index].first, (*m_values)[index].second);
+  }
+
+  string
+  RegexNameView::toEscapedString(size_t index) const
+  {
+    if(0 != m_name)
+      return m_name->get(index).toEscapedString();
+    else
+      return escape((*m_values)[index].first, (*m_values)[index].second);
+  }
+
+  string
+  RegexNameView::escape(const uint8_t* value, size_t size)
+  {
+    bool gotNonDot = false;
+    for(size_t i = 0; i < size; i++)
+      {
+        if('.' != value[i])
+          {
+            gotNonDot = true;
+            break;
+          }
+      }
+
+    // a component of only dots has three more dots, so that it is not confused with . and ..
+    if(!gotNonDot)
+      return string(size + 3, '.');
+
+    string escaped;
+    escaped.reserve(size);
+    for(size_t i = 0; i < size; i++)
+      {
+        uint8_t c = value[i];
+        if((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+           '+' == c || '-' == c || '.' == c || '_' == c)
+          escaped.push_back(c);
+        else
+          {
+            char hex[4];
+            snprintf(hex, sizeof(hex), "%%%02X", c);
+            escaped.append(hex);
+          }
+      }
+    return escaped;
+  }
+
+}//ndn
@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_REGEX_NAME_VIEW_H
+#define NDN_REGEX_NAME_VIEW_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <ndn-cpp-dev/name.hpp>
+
+namespace ndn
+{
+  class RegexMatchMemo;
+
+  /**
+   * @brief The name a regex is matched against.
+   *
+   * A view refers either to a decoded Name or to a wire-encoded Name TLV, in which case
+   * component values are read in place from the packet buffer.  The view does not own
+   * the name or the buffer, both must outlive the match.
+   */
+  class RegexNameView
+  {
+  public:
+    /**
+     * @brief The component values of a wire-encoded name, pointers into the packet buffer
+     */
+    typedef std::vector<std::pair<const uint8_t*, size_t> > ValueList;
+
+    RegexNameView(const Name& name);
+
+    /**
+     * @brief Create a view of a wire-encoded name, the components are read in place
+     *
+     * The TLVs are walked directly, wire is not parsed, so a Block shared between threads
+     * can be viewed concurrently.
+     *
+     * @param wire The Name TLV
+     * @throws RegexException if wire is not an encoded Name TLV
+     */
+    RegexNameView(const Block& wire);
+
+    /**
+     * @brief Create a view of a wire-encoded name, keeping the component values in values
+     * @param wire The Name TLV
+     * @param values The storage of the component values, cleared first; reusing it across
+     *               views avoids allocating once its capacity suffices. It must outlive the view.
+     * @throws RegexException if wire is not an encoded Name TLV
+     */
+    RegexNameView(const Block& wire, ValueList& values);
+
+    /**
+     * @brief Create a view of a wire-encoded name held in a raw buffer
+     * @param wire The Name TLV
+     * @param size The size of the Name TLV
+     * @throws RegexException if the buffer does not hold a well-formed Name TLV
+     */
+    RegexNameView(const uint8_t* wire, size_t size);
+
+    /**
+     * @brief Create a view of a wire-encoded name held in a raw buffer, keeping the component
+     *        values in values (see RegexNameView(const Block&, ValueList&))
+     */
+    RegexNameView(const uint8_t* wire, size_t size, ValueList& values);
+
+    RegexNameView(const RegexNameView& other);
+
+    size_t
+    size() const
+    { return 0 != m_name ? m_name->size() : m_values->size(); }
+
+    const uint8_t*
+    getValue(size_t index) const
+    { return 0 != m_name ? m_name->get(index).value() : (*m_values)[index].first; }
+
+    size_t
+    getValueSize(size_t index) const
+    { return 0 != m_name ? m_name->get(index).value_size() : (*m_values)[index].second; }
+
+    /**
+     * @brief get a component as a Name::Component
+     *
+     * The value of a component of a wire-encoded name is copied; components of a decoded
+     * Name are shared.
+     */
+    Name::Component
+    get(size_t index) const;
+
+    /**
+     * @brief get the escaped form of a component, as Name::Component::toEscapedString
+     */
+    std::string
+    toEscapedString(size_t index) const;
+
+    static std::string
+    escape(const uint8_t* value, size_t size);
+
+    /**
+     * @brief attach a memo of the results of shared sub-patterns on this name, so that the
+     *        expressions matched against the view reuse them (see RegexMatchMemo)
+     * @param memo The memo, or 0 to match without memo; it must outlive the matches
+     */
+    void
+    setMemo(RegexMatchMemo* memo)
+    { m_memo = memo; }
+
+    RegexMatchMemo*
+    getMemo() const
+    { return m_memo; }
+
+  private:
+    RegexNameView&
+    operator=(const RegexNameView& other);
+
+    void
+    parseWire(const uint8_t* wire, size_t size);
+
+  private:
+    const Name* m_name;
+    ValueList* m_values;
+    ValueList m_ownValues;
+    RegexMatchMemo* m_memo;
+  };
+
+}//ndn
+
+#endif
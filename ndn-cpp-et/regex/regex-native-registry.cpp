@@ -0,0 +1,65 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <map>
+
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "regex-native-registry.hpp"
+
+#include "logging.h"
+
+INIT_LOGGER ("RegexNativeRegistry");
+
+using namespace std;
+
+namespace ndn
+{
+  typedef map<string, RegexNativeMatcher> NativeMatcherMap;
+
+  // Generated translation units register themselves during static initialization,
+  // so the map must be constructed on first use rather than as a global.
+  static NativeMatcherMap&
+  getNativeMatchers()
+  {
+    static NativeMatcherMap nativeMatchers;
+    return nativeMatchers;
+  }
+
+  static boost::mutex&
+  getNativeMatchersMutex()
+  {
+    static boost::mutex nativeMatchersMutex;
+    return nativeMatchersMutex;
+  }
+
+  void
+  RegexNativeRegistry::registerMatcher(const string& expr, RegexNativeMatcher matcher)
+  {
+    boost::lock_guard<boost::mutex> lock(getNativeMatchersMutex());
+    getNativeMatchers()[expr] = matcher;
+  }
+
+  void
+  RegexNativeRegistry::unregisterMatcher(const string& expr)
+  {
+    boost::lock_guard<boost::mutex> lock(getNativeMatchersMutex());
+    getNativeMatchers().erase(expr);
+  }
+
+  RegexNativeMatcher
+  RegexNativeRegistry::findMatcher(const string& expr)
+  {
+    boost::lock_guard<boost::mutex> lock(getNativeMatchersMutex());
+    NativeMatcherMap::const_iterator it = getNativeMatchers().find(expr);
+    if(it == getNativeMatchers().end())
+      return 0;
+    return it->second;
+  }
+
+}//ndn
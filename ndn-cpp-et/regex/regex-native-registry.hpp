@@ -0,0 +1,48 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_REGEX_NATIVE_REGISTRY_H
+#define NDN_REGEX_NATIVE_REGISTRY_H
+
+#include <string>
+#include "regex-name-view.hpp"
+
+namespace ndn
+{
+  /**
+   * @brief A natively compiled matcher, generated by ndn-regex-codegen
+   * @returns true if the whole name matches the expression
+   */
+  typedef bool (*RegexNativeMatcher)(const RegexNameView& name);
+
+  /**
+   * @brief Registry of natively compiled matchers keyed by expression string.
+   *
+   * RegexTopMatcher looks up its expression here when it is constructed, and uses the
+   * native matcher to decide whether a name matches. The interpreted matcher tree is
+   * still used to collect back references when the expression has any.
+   */
+  class RegexNativeRegistry
+  {
+  public:
+    static void
+    registerMatcher(const std::string& expr, RegexNativeMatcher matcher);
+
+    static void
+    unregisterMatcher(const std::string& expr);
+
+    /**
+     * @brief find the native matcher of an expression
+     * @returns the native matcher, or 0 if the expression has not been compiled
+     */
+    static RegexNativeMatcher
+    findMatcher(const std::string& expr);
+  };
+
+}//ndn
+
+#endif
@@ -8,6 +8,7 @@
 #include "regex-pattern-list-matcher.hpp"
 #include "regex-backref-matcher.hpp"
 #include "regex-repeat-matcher.hpp"
+#include "regex-subpattern-table.hpp"
 #include "regex-exception.hpp"
 
 #include "logging.h"
@@ -25,6 +26,14 @@ namespace ndn
     compile();
     // _LOG_TRACE ("Exit RegexPatternListMatcher Constructor");
   }
+
+  RegexPatternListMatcher::RegexPatternListMatcher(const string expr, 
+                                                   ptr_lib::shared_ptr<RegexBackrefManager> backrefManager,
+                                                   const vector<ptr_lib::shared_ptr<RegexMatcher> >& matcherList)
+    :RegexMatcher(expr, EXPR_PATTERNLIST, backrefManager)
+  {
+    m_matcherList = matcherList;
+  }
   
   void 
   RegexPatternListMatcher::compile()
@@ -80,7 +89,7 @@ namespace ndn
       index = extractSubPattern ('<', '>', index);
       indicator = index;
       end = extractRepetition(index);
-      m_matcherList.push_back(ptr_lib::make_shared<RegexRepeatMatcher>(m_expr.substr(start, end - start), m_backrefManager, indicator - start));
+      m_matcherList.push_back(RegexSubpatternTable::getRepeatMatcher(m_expr.substr(start, end - start), m_backrefManager, indicator - start));
       break;
 
     case '[':
@@ -88,7 +97,7 @@ namespace ndn
       index = extractSubPattern ('[', ']', index);
       indicator = index;
       end = extractRepetition(index);
-      m_matcherList.push_back(ptr_lib::make_shared<RegexRepeatMatcher>(m_expr.substr(start, end - start), m_backrefManager, indicator - start));
+      m_matcherList.push_back(RegexSubpatternTable::getRepeatMatcher(m_expr.substr(start, end - start), m_backrefManager, indicator - start));
       break;
 
     default:
@@ -19,6 +19,16 @@ namespace ndn
   {
   public:
     RegexPatternListMatcher(const std::string expr, ptr_lib::shared_ptr<RegexBackrefManager> backRefManager);
+
+    /**
+     * @brief Create a RegexPatternListMatcher from already compiled sub-matchers
+     * @param expr The expression the sub-matchers were compiled from
+     * @param backRefManager The back reference manager
+     * @param matcherList The sub-matchers
+     */
+    RegexPatternListMatcher(const std::string expr, 
+                            ptr_lib::shared_ptr<RegexBackrefManager> backRefManager,
+                            const std::vector<ptr_lib::shared_ptr<RegexMatcher> >& matcherList);
     
     virtual ~RegexPatternListMatcher(){};
 
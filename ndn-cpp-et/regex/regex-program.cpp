@@ -0,0 +1,451 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <limits>
+#include <map>
+
+#include "regex-program.hpp"
+#include "regex-backref-matcher.hpp"
+#include "regex-repeat-matcher.hpp"
+#include "regex-component-set-matcher.hpp"
+#include "regex-exception.hpp"
+
+#include "logging.h"
+
+INIT_LOGGER ("RegexProgram");
+
+using namespace std;
+
+namespace ndn
+{
+  const uint32_t RegexProgram::VERSION = 1;
+
+  static const char PROGRAM_MAGIC[8] = { 'N', 'D', 'N', 'R', 'G', 'X', 'P', 0 };
+
+  class RegexProgramEncoder
+  {
+  public:
+    void
+    writeUint8(uint8_t value)
+    { m_buffer.push_back(static_cast<char>(value)); }
+
+    void
+    writeUint32(uint32_t value)
+    {
+      for(int i = 0; i < 4; i++)
+        m_buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+
+    void
+    writeString(const string& str)
+    {
+      writeUint32(str.size());
+      m_buffer.append(str);
+    }
+
+    void
+    writeSection(const RegexMatcher& patternList, RegexBackrefManager& backRefManager);
+
+    const string&
+    getBuffer() const
+    { return m_buffer; }
+
+  private:
+    uint32_t
+    writeNode(const RegexMatcher& matcher);
+
+  private:
+    string m_buffer;
+    string m_nodes;
+    uint32_t m_nodeCount;
+    map<const RegexMatcher*, uint32_t> m_nodeIds;
+  };
+
+  void
+  RegexProgramEncoder::writeSection(const RegexMatcher& patternList, RegexBackrefManager& backRefManager)
+  {
+    // nodes are encoded into a separate buffer, because their number is only known at the end
+    string buffer;
+    buffer.swap(m_buffer);
+    m_nodeCount = 0;
+    m_nodeIds.clear();
+
+    uint32_t rootId = writeNode(patternList);
+
+    m_nodes.swap(m_buffer);
+    m_buffer.swap(buffer);
+    writeUint32(m_nodeCount);
+    m_buffer.append(m_nodes);
+    m_nodes.clear();
+
+    writeUint32(rootId);
+    writeUint32(backRefManager.size());
+    for(int i = 0; i < backRefManager.size(); i++)
+      {
+        map<const RegexMatcher*, uint32_t>::const_iterator it = m_nodeIds.find(backRefManager.getBackRef(i).get());
+        if(it == m_nodeIds.end())
+          throw RegexException("RegexProgram: back reference is not in the matcher tree");
+        writeUint32(it->second);
+      }
+  }
+
+  uint32_t
+  RegexProgramEncoder::writeNode(const RegexMatcher& matcher)
+  {
+    map<const RegexMatcher*, uint32_t>::const_iterator it = m_nodeIds.find(&matcher);
+    if(it != m_nodeIds.end())
+      return it->second;
+
+    vector<uint32_t> children;
+    switch(matcher.getType()){
+    case RegexMatcher::EXPR_PATTERNLIST:
+    case RegexMatcher::EXPR_BACKREF:
+    case RegexMatcher::EXPR_REPEAT_PATTERN:
+      {
+        const vector<ptr_lib::shared_ptr<RegexMatcher> >& matcherList = matcher.getMatcherList();
+        for(size_t i = 0; i < matcherList.size(); i++)
+          children.push_back(writeNode(*matcherList[i]));
+        break;
+      }
+    case RegexMatcher::EXPR_COMPONENT_SET:
+      {
+        const RegexComponentSetMatcher& componentSet = static_cast<const RegexComponentSetMatcher&>(matcher);
+        set<ptr_lib::shared_ptr<RegexComponentMatcher> >::const_iterator componentIt = componentSet.getComponents().begin();
+        for(; componentIt != componentSet.getComponents().end(); componentIt++)
+          children.push_back(writeNode(**componentIt));
+        break;
+      }
+    case RegexMatcher::EXPR_COMPONENT:
+      {
+        const RegexComponentMatcher& component = static_cast<const RegexComponentMatcher&>(matcher);
+        for(size_t i = 0; i < component.getPseudoMatchers().size(); i++)
+          children.push_back(writeNode(*component.getPseudoMatchers()[i]));
+        break;
+      }
+    case RegexMatcher::EXPR_PSEUDO:
+      break;
+    default:
+      throw RegexException("RegexProgram: cannot write matcher " + matcher.getExpr());
+    }
+
+    writeUint8(matcher.getType());
+    writeString(matcher.getExpr());
+
+    switch(matcher.getType()){
+    case RegexMatcher::EXPR_REPEAT_PATTERN:
+      {
+        const RegexRepeatMatcher& repeat = static_cast<const RegexRepeatMatcher&>(matcher);
+        writeUint32(repeat.getIndicator());
+        writeUint32(repeat.getRepeatMin());
+        writeUint32(repeat.getRepeatMax());
+        break;
+      }
+    case RegexMatcher::EXPR_COMPONENT_SET:
+      writeUint8(static_cast<const RegexComponentSetMatcher&>(matcher).isInclusive() ? 1 : 0);
+      break;
+    case RegexMatcher::EXPR_COMPONENT:
+      writeUint8(static_cast<const RegexComponentMatcher&>(matcher).isExact() ? 1 : 0);
+      break;
+    default:
+      break;
+    }
+
+    writeUint32(children.size());
+    for(size_t i = 0; i < children.size(); i++)
+      writeUint32(children[i]);
+
+    m_nodeIds[&matcher] = m_nodeCount;
+    return m_nodeCount++;
+  }
+
+  class RegexProgramDecoder
+  {
+  public:
+    RegexProgramDecoder(const uint8_t* buffer, size_t size)
+      : m_begin(buffer),
+        m_end(buffer + size)
+    {}
+
+    const uint8_t*
+    readBytes(size_t size)
+    {
+      if(static_cast<size_t>(m_end - m_begin) < size)
+        throw RegexException("RegexProgram: unexpected end of program");
+      const uint8_t* bytes = m_begin;
+      m_begin += size;
+      return bytes;
+    }
+
+    uint8_t
+    readUint8()
+    { return *readBytes(1); }
+
+    uint32_t
+    readUint32()
+    {
+      const uint8_t* bytes = readBytes(4);
+      return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    int
+    readInt()
+    {
+      uint32_t value = readUint32();
+      if(value > static_cast<uint32_t>(numeric_limits<int>::max()))
+        throw RegexException("RegexProgram: integer out of range");
+      return static_cast<int>(value);
+    }
+
+    /**
+     * @brief read a count of elements of elementSize bytes each, which must fit in the
+     *        remaining bytes, before anything is allocated for them
+     */
+    uint32_t
+    readCount(size_t elementSize)
+    {
+      uint32_t count = readUint32();
+      if(count > static_cast<size_t>(m_end - m_begin) / elementSize)
+        throw RegexException("RegexProgram: unexpected end of program");
+      return count;
+    }
+
+    string
+    readString()
+    {
+      uint32_t size = readUint32();
+      return string(reinterpret_cast<const char*>(readBytes(size)), size);
+    }
+
+    ptr_lib::shared_ptr<RegexPatternListMatcher>
+    readSection(ptr_lib::shared_ptr<RegexBackrefManager> backRefManager);
+
+    bool
+    isEnd() const
+    { return m_begin == m_end; }
+
+  private:
+    template<class T> ptr_lib::shared_ptr<T>
+    getNode(const vector<ptr_lib::shared_ptr<RegexMatcher> >& nodes, uint32_t id, RegexMatcher::RegexExprType type)
+    {
+      if(id >= nodes.size() || type != nodes[id]->getType())
+        throw RegexException("RegexProgram: wrong node reference");
+      return ptr_lib::static_pointer_cast<T>(nodes[id]);
+    }
+
+  private:
+    const uint8_t* m_begin;
+    const uint8_t* m_end;
+  };
+
+  ptr_lib::shared_ptr<RegexPatternListMatcher>
+  RegexProgramDecoder::readSection(ptr_lib::shared_ptr<RegexBackrefManager> backRefManager)
+  {
+    uint32_t nodeCount = readUint32();
+    vector<ptr_lib::shared_ptr<RegexMatcher> > nodes;
+
+    for(uint32_t id = 0; id < nodeCount; id++)
+      {
+        uint8_t type = readUint8();
+        string expr = readString();
+
+        int indicator = 0;
+        int repeatMin = 0;
+        int repeatMax = 0;
+        bool flag = false;
+        if(RegexMatcher::EXPR_REPEAT_PATTERN == type)
+          {
+            indicator = readInt();
+            repeatMin = readInt();
+            repeatMax = readInt();
+            // the repeated pattern is the expression up to the indicator
+            if(0 == indicator || static_cast<size_t>(indicator) > expr.size() || repeatMin > repeatMax)
+              throw RegexException("RegexProgram: malformed repetition " + expr);
+          }
+        else if(RegexMatcher::EXPR_COMPONENT_SET == type || RegexMatcher::EXPR_COMPONENT == type)
+          flag = (0 != readUint8());
+
+        vector<uint32_t> children(readCount(4));
+        for(size_t i = 0; i < children.size(); i++)
+          {
+            children[i] = readUint32();
+            if(children[i] >= id)
+              throw RegexException("RegexProgram: wrong node reference");
+          }
+
+        ptr_lib::shared_ptr<RegexMatcher> node;
+        switch(type){
+        case RegexMatcher::EXPR_PATTERNLIST:
+          {
+            vector<ptr_lib::shared_ptr<RegexMatcher> > matcherList;
+            for(size_t i = 0; i < children.size(); i++)
+              matcherList.push_back(nodes[children[i]]);
+            node = ptr_lib::make_shared<RegexPatternListMatcher>(expr, backRefManager, matcherList);
+            break;
+          }
+        case RegexMatcher::EXPR_BACKREF:
+          if(1 != children.size())
+            throw RegexException("RegexProgram: malformed back reference " + expr);
+          node = ptr_lib::make_shared<RegexBackrefMatcher>(expr, backRefManager,
+                                                           getNode<RegexMatcher>(nodes, children[0], RegexMatcher::EXPR_PATTERNLIST));
+          break;
+        case RegexMatcher::EXPR_REPEAT_PATTERN:
+          if(1 != children.size())
+            throw RegexException("RegexProgram: malformed repetition " + expr);
+          node = ptr_lib::make_shared<RegexRepeatMatcher>(expr, backRefManager, indicator, repeatMin, repeatMax, nodes[children[0]]);
+          break;
+        case RegexMatcher::EXPR_COMPONENT_SET:
+          {
+            set<ptr_lib::shared_ptr<RegexComponentMatcher> > components;
+            for(size_t i = 0; i < children.size(); i++)
+              components.insert(getNode<RegexComponentMatcher>(nodes, children[i], RegexMatcher::EXPR_COMPONENT));
+            node = ptr_lib::make_shared<RegexComponentSetMatcher>(expr, backRefManager, flag, components);
+            break;
+          }
+        case RegexMatcher::EXPR_COMPONENT:
+          {
+            vector<ptr_lib::shared_ptr<RegexPseudoMatcher> > pseudoMatchers;
+            for(size_t i = 0; i < children.size(); i++)
+              pseudoMatchers.push_back(getNode<RegexPseudoMatcher>(nodes, children[i], RegexMatcher::EXPR_PSEUDO));
+            node = ptr_lib::make_shared<RegexComponentMatcher>(expr, backRefManager, flag, pseudoMatchers);
+            break;
+          }
+        case RegexMatcher::EXPR_PSEUDO:
+          node = ptr_lib::make_shared<RegexPseudoMatcher>();
+          break;
+        default:
+          throw RegexException("RegexProgram: unknown matcher type");
+        }
+        nodes.push_back(node);
+      }
+
+    ptr_lib::shared_ptr<RegexPatternListMatcher> root = getNode<RegexPatternListMatcher>(nodes, readUint32(), RegexMatcher::EXPR_PATTERNLIST);
+
+    uint32_t refCount = readUint32();
+    for(uint32_t i = 0; i < refCount; i++)
+      {
+        uint32_t id = readUint32();
+        if(id >= nodes.size())
+          throw RegexException("RegexProgram: wrong back reference");
+        backRefManager->pushRef(nodes[id]);
+      }
+
+    return root;
+  }
+
+  void
+  RegexProgram::write(ostream& os, const vector<ptr_lib::shared_ptr<RegexTopMatcher> >& matchers)
+  {
+    RegexProgramEncoder encoder;
+    encoder.writeUint32(VERSION);
+    encoder.writeUint32(matchers.size());
+
+    vector<ptr_lib::shared_ptr<RegexTopMatcher> >::const_iterator it = matchers.begin();
+    for(; it != matchers.end(); it++)
+      {
+        ptr_lib::shared_ptr<RegexTopMatcher> matcher = *it;
+        // matchers without a matcher tree (RegexLiteralMatcher) are written as the equivalent regex
+        if(!static_cast<bool>(matcher->getPrimaryMatcher()))
+          matcher = ptr_lib::make_shared<RegexTopMatcher>(matcher->getExpr(), matcher->getExpand());
+
+        encoder.writeString(matcher->getExpr());
+        encoder.writeString(matcher->getExpand());
+        encoder.writeUint8(static_cast<bool>(matcher->getSecondaryMatcher()) ? 1 : 0);
+
+        encoder.writeSection(*matcher->getPrimaryMatcher(), *matcher->getPrimaryBackRefManager());
+        if(static_cast<bool>(matcher->getSecondaryMatcher()))
+          encoder.writeSection(*matcher->getSecondaryMatcher(), *matcher->getSecondaryBackRefManager());
+      }
+
+    os.write(PROGRAM_MAGIC, sizeof(PROGRAM_MAGIC));
+    os.write(encoder.getBuffer().c_str(), encoder.getBuffer().size());
+  }
+
+  void
+  RegexProgram::writeToFile(const string& path, const vector<ptr_lib::shared_ptr<RegexTopMatcher> >& matchers)
+  {
+    ofstream os(path.c_str(), ios_base::out | ios_base::binary | ios_base::trunc);
+    if(!os.is_open())
+      throw RegexException("RegexProgram: cannot open " + path);
+
+    write(os, matchers);
+  }
+
+  vector<ptr_lib::shared_ptr<RegexTopMatcher> >
+  RegexProgram::load(const uint8_t* buffer, size_t size)
+  {
+    RegexProgramDecoder decoder(buffer, size);
+
+    if(0 != memcmp(decoder.readBytes(sizeof(PROGRAM_MAGIC)), PROGRAM_MAGIC, sizeof(PROGRAM_MAGIC)))
+      throw RegexException("RegexProgram: not a regex program");
+    if(VERSION != decoder.readUint32())
+      throw RegexException("RegexProgram: unsupported version");
+
+    vector<ptr_lib::shared_ptr<RegexTopMatcher> > matchers;
+    uint32_t count = decoder.readUint32();
+    for(uint32_t i = 0; i < count; i++)
+      {
+        string expr = decoder.readString();
+        string expand = decoder.readString();
+        bool hasSecondary = (0 != decoder.readUint8());
+
+        ptr_lib::shared_ptr<RegexBackrefManager> primaryBackRefManager = ptr_lib::make_shared<RegexBackrefManager>();
+        ptr_lib::shared_ptr<RegexBackrefManager> secondaryBackRefManager = ptr_lib::make_shared<RegexBackrefManager>();
+        ptr_lib::shared_ptr<RegexPatternListMatcher> primaryMatcher = decoder.readSection(primaryBackRefManager);
+        ptr_lib::shared_ptr<RegexPatternListMatcher> secondaryMatcher;
+        if(hasSecondary)
+          secondaryMatcher = decoder.readSection(secondaryBackRefManager);
+
+        matchers.push_back(ptr_lib::make_shared<RegexTopMatcher>(expr, expand,
+                                                                 primaryMatcher, primaryBackRefManager,
+                                                                 secondaryMatcher, secondaryBackRefManager));
+      }
+
+    if(!decoder.isEnd())
+      throw RegexException("RegexProgram: trailing bytes after the last program");
+
+    return matchers;
+  }
+
+  vector<ptr_lib::shared_ptr<RegexTopMatcher> >
+  RegexProgram::loadFromFile(const string& path)
+  {
+    int fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+      throw RegexException("RegexProgram: cannot open " + path);
+
+    struct stat st;
+    if(0 != fstat(fd, &st) || 0 == st.st_size)
+      {
+        close(fd);
+        throw RegexException("RegexProgram: cannot read " + path);
+      }
+
+    void* buffer = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(MAP_FAILED == buffer)
+      throw RegexException("RegexProgram: cannot map " + path);
+
+    try{
+      // the matchers copy what they need, so the mapping is released right after loading
+      vector<ptr_lib::shared_ptr<RegexTopMatcher> > matchers = load(static_cast<const uint8_t*>(buffer), st.st_size);
+      munmap(buffer, st.st_size);
+      return matchers;
+    }catch(...){
+      // std::bad_alloc included
+      munmap(buffer, st.st_size);
+      throw;
+    }
+  }
+
+}//ndn
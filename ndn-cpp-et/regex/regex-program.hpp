@@ -0,0 +1,71 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_REGEX_PROGRAM_H
+#define NDN_REGEX_PROGRAM_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "regex-top-matcher.hpp"
+
+namespace ndn
+{
+  /**
+   * @brief Binary format of compiled RegexTopMatchers.
+   *
+   * A program stores the matcher tree of each expression (component expressions, repeat
+   * bounds, set inclusion), the order of back references and the default expand string.
+   * Loading a program rebuilds ready-to-run matchers without parsing the expressions;
+   * the boost::regex of a component is only compiled when the component is first matched.
+   *
+   * Layout (integers are little-endian, strings are a uint32 length followed by the bytes):
+   *
+   *   "NDNRGXP\0" uint32(version) uint32(count) program*
+   *   program := string(expr) string(expand) uint8(hasSecondary) section [section]
+   *   section := uint32(nodeCount) node* uint32(rootId) uint32(refCount) uint32(nodeId)*
+   *   node    := uint8(type) string(expr) fields
+   *
+   * Nodes are written children first, so a node only refers to nodes written before it.
+   */
+  class RegexProgram
+  {
+  public:
+    static const uint32_t VERSION;
+
+    /**
+     * @brief write compiled matchers
+     * @param os The output stream, which should be opened in binary mode
+     * @param matchers The matchers to write
+     */
+    static void
+    write(std::ostream& os, const std::vector<ptr_lib::shared_ptr<RegexTopMatcher> >& matchers);
+
+    static void
+    writeToFile(const std::string& path, const std::vector<ptr_lib::shared_ptr<RegexTopMatcher> >& matchers);
+
+    /**
+     * @brief rebuild the matchers of a program
+     * @param buffer The program
+     * @param size The size of the program
+     * @returns the matchers in the order they were written
+     * @throws RegexException if the program is malformed or of another version
+     */
+    static std::vector<ptr_lib::shared_ptr<RegexTopMatcher> >
+    load(const uint8_t* buffer, size_t size);
+
+    /**
+     * @brief map a program file into memory and rebuild its matchers
+     */
+    static std::vector<ptr_lib::shared_ptr<RegexTopMatcher> >
+    loadFromFile(const std::string& path);
+  };
+
+}//ndn
+
+#endif
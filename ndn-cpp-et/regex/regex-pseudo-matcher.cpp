@@ -22,9 +22,5 @@ namespace ndn
   void 
   RegexPseudoMatcher::setMatchResult(const string & str)
   { m_matchResult.push_back(Name::Component((const uint8_t *)str.c_str(), str.size())); }
-    
-  void 
-  RegexPseudoMatcher::resetMatchResult()
-  { m_matchResult.clear(); }
 
 }//ndn
@@ -26,9 +26,6 @@ namespace ndn
 
     void 
     setMatchResult(const std::string& str);
-
-    void 
-    resetMatchResult();
   };
 
 }//ndn
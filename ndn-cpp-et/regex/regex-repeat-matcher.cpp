@@ -13,6 +13,8 @@
 #include "regex-repeat-matcher.hpp"
 #include "regex-backref-matcher.hpp"
 #include "regex-component-set-matcher.hpp"
+#include "regex-match-memo.hpp"
+#include "regex-match-trace.hpp"
 #include "regex-exception.hpp"
 
 #include "logging.h"
@@ -32,6 +34,20 @@ namespace ndn
     // _LOG_TRACE ("Exit RegexRepeatMatcher Constructor");
   }
 
+  RegexRepeatMatcher::RegexRepeatMatcher(const string expr, 
+                                         ptr_lib::shared_ptr<RegexBackrefManager> backrefManager, 
+                                         int indicator,
+                                         int repeatMin,
+                                         int repeatMax,
+                                         ptr_lib::shared_ptr<RegexMatcher> matcher)
+    : RegexMatcher (expr, EXPR_REPEAT_PATTERN, backrefManager),
+      m_indicator(indicator),
+      m_repeatMin(repeatMin),
+      m_repeatMax(repeatMax)
+  {
+    m_matcherList.push_back(matcher);
+  }
+
   void 
   RegexRepeatMatcher::compile()
   {
@@ -130,11 +146,16 @@ namespace ndn
   }
 
   bool
-  RegexRepeatMatcher::match(const Name & name, const int & offset, const int & len)
+  RegexRepeatMatcher::match(const RegexNameView & name, const int & offset, const int & len)
   {
     // _LOG_TRACE ("Enter RegexRepeatMatcher::match");
+    REGEX_TRACE_MATCH(this);
+
+    if (isShared())
+      return matchShared(name, offset, len);
 
     m_matchResult.clear();
+    m_matchOffset = offset;
 
     if (0 == m_repeatMin)
       if (0 == len)
@@ -150,10 +171,29 @@ namespace ndn
       return false;
   }
 
+  bool
+  RegexRepeatMatcher::matchShared(const RegexNameView & name, const int & offset, const int & len)
+  {
+    RegexMatchMemo* memo = name.getMemo();
+    if (0 != memo)
+      {
+        int recorded = memo->find(this, offset, len);
+        if (0 <= recorded)
+          return 1 == recorded;
+      }
+
+    bool matched = ((0 == m_repeatMin && 0 == len) || recursiveMatch(0, name, offset, len));
+
+    if (0 != memo)
+      memo->insert(this, offset, len, matched);
+    return matched;
+  }
+
   bool 
-  RegexRepeatMatcher::recursiveMatch(int repeat, const Name & name, const int & offset, const int & len)
+  RegexRepeatMatcher::recursiveMatch(int repeat, const RegexNameView & name, const int & offset, const int & len)
   {
     // _LOG_TRACE ("Enter RegexRepeatMatcher::recursiveMatch");
+    REGEX_TRACE_RECURSE(this);
 
     // _LOG_DEBUG ("repeat: " << repeat << " offset: " << offset << " len: " << len);
     // _LOG_DEBUG ("m_repeatMin: " << m_repeatMin << " m_repeatMax: " << m_repeatMax);
@@ -186,6 +226,7 @@ namespace ndn
         if (matcher->match(name, offset, tried) and recursiveMatch(repeat + 1, name, offset + tried, len - tried))
           return true;
         // _LOG_DEBUG("Failed at tried: " << tried);
+        REGEX_TRACE_BACKTRACK(this);
         tried --;
       }
 
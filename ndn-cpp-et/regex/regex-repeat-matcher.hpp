@@ -17,11 +17,43 @@ namespace ndn
   {
   public:
     RegexRepeatMatcher(const std::string expr, ptr_lib::shared_ptr<RegexBackrefManager> backRefManager, int indicator);
+
+    /**
+     * @brief Create a RegexRepeatMatcher from an already compiled sub-matcher and repetition
+     * @param expr The expression the matcher was compiled from
+     * @param backRefManager The back reference manager
+     * @param indicator The position of the repetition in expr
+     * @param repeatMin The minimum number of repetitions
+     * @param repeatMax The maximum number of repetitions
+     * @param matcher The compiled matcher to repeat
+     */
+    RegexRepeatMatcher(const std::string expr, 
+                       ptr_lib::shared_ptr<RegexBackrefManager> backRefManager, 
+                       int indicator,
+                       int repeatMin,
+                       int repeatMax,
+                       ptr_lib::shared_ptr<RegexMatcher> matcher);
     
     virtual ~RegexRepeatMatcher(){}
 
     virtual bool 
-    match(const Name & name, const int & offset, const int & len);
+    match(const RegexNameView & name, const int & offset, const int & len);
+
+    int
+    getIndicator() const
+    { return m_indicator; }
+
+    int
+    getRepeatMin() const
+    { return m_repeatMin; }
+
+    /**
+     * @brief get the maximum number of repetitions
+     * @returns the maximum, std::numeric_limits<int>::max() if unbounded
+     */
+    int
+    getRepeatMax() const
+    { return m_repeatMax; }
 
   protected:
     /**
@@ -36,9 +68,15 @@ namespace ndn
     bool 
     parseRepetition();
 
+    /**
+     * @brief match without recording the match result, using the memo of the name if any
+     */
+    bool
+    matchShared(const RegexNameView & name, const int & offset, const int & len);
+
     bool 
     recursiveMatch (int repeat,
-                    const Name & name,
+                    const RegexNameView & name,
                     const int & offset,
                     const int &len);
   
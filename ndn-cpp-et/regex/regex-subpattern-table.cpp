@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <map>
+
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "regex-subpattern-table.hpp"
+#include "regex-repeat-matcher.hpp"
+#include "regex-component-set-matcher.hpp"
+
+#include "logging.h"
+
+INIT_LOGGER ("RegexSubpatternTable");
+
+using namespace std;
+
+namespace ndn
+{
+  typedef map<string, ptr_lib::weak_ptr<RegexMatcher> > SubpatternMap;
+
+  static const size_t MIN_SWEEP_SIZE = 64;
+
+  static SubpatternMap&
+  getSubpatterns()
+  {
+    static SubpatternMap subpatterns;
+    return subpatterns;
+  }
+
+  // Never destroyed: a sub-pattern released after static destruction still returns its memo id.
+  static boost::mutex&
+  getSubpatternsMutex()
+  {
+    static boost::mutex* subpatternsMutex = new boost::mutex;
+    return *subpatternsMutex;
+  }
+
+  // ids of released sub-patterns, and the number of ids given so far
+  static vector<size_t>&
+  getFreeMemoIds()
+  {
+    static vector<size_t>* freeMemoIds = new vector<size_t>;
+    return *freeMemoIds;
+  }
+
+  static size_t memoIdCount = 0;
+
+  // drop the entries of released sub-patterns once the map has doubled since the last sweep
+  static void
+  sweepSubpatterns()
+  {
+    static size_t sweepSize = MIN_SWEEP_SIZE;
+
+    SubpatternMap& subpatterns = getSubpatterns();
+    if(subpatterns.size() < sweepSize)
+      return;
+
+    SubpatternMap::iterator it = subpatterns.begin();
+    while(it != subpatterns.end())
+      {
+        if(it->second.expired())
+          subpatterns.erase(it++);
+        else
+          it++;
+      }
+    sweepSize = max(MIN_SWEEP_SIZE, 2 * subpatterns.size());
+  }
+
+  ptr_lib::shared_ptr<RegexMatcher>
+  RegexSubpatternTable::getRepeatMatcher(const string& expr,
+                                         ptr_lib::shared_ptr<RegexBackrefManager> backrefManager,
+                                         int indicator)
+  {
+    // marked sub-expressions of a component are back references of the enclosing expression
+    if(string::npos != expr.find('('))
+      return ptr_lib::make_shared<RegexRepeatMatcher>(expr, backrefManager, indicator);
+
+    boost::lock_guard<boost::mutex> lock(getSubpatternsMutex());
+
+    ptr_lib::weak_ptr<RegexMatcher>& entry = getSubpatterns()[expr];
+    ptr_lib::shared_ptr<RegexMatcher> matcher = entry.lock();
+    if(static_cast<bool>(matcher))
+      return matcher;
+
+    // a component set without marked sub-expressions never uses the back reference manager
+    matcher = ptr_lib::make_shared<RegexRepeatMatcher>(expr, ptr_lib::make_shared<RegexBackrefManager>(), indicator);
+    setShared(*matcher);
+    if(getFreeMemoIds().empty())
+      matcher->m_memoId = memoIdCount++;
+    else
+      {
+        matcher->m_memoId = getFreeMemoIds().back();
+        getFreeMemoIds().pop_back();
+      }
+    entry = matcher;
+
+    sweepSubpatterns();
+    return matcher;
+  }
+
+  size_t
+  RegexSubpatternTable::size()
+  {
+    boost::lock_guard<boost::mutex> lock(getSubpatternsMutex());
+
+    size_t count = 0;
+    SubpatternMap::const_iterator it = getSubpatterns().begin();
+    for(; it != getSubpatterns().end(); it++)
+      {
+        if(!it->second.expired())
+          count++;
+      }
+    return count;
+  }
+
+  size_t
+  RegexSubpatternTable::getMemoIdCount()
+  {
+    boost::lock_guard<boost::mutex> lock(getSubpatternsMutex());
+    return memoIdCount;
+  }
+
+  void
+  RegexSubpatternTable::releaseMemoId(size_t memoId)
+  {
+    boost::lock_guard<boost::mutex> lock(getSubpatternsMutex());
+    getFreeMemoIds().push_back(memoId);
+  }
+
+  void
+  RegexSubpatternTable::setShared(RegexMatcher& matcher)
+  {
+    matcher.m_shared = true;
+
+    vector<ptr_lib::shared_ptr<RegexMatcher> >::const_iterator it = matcher.getMatcherList().begin();
+    for(; it != matcher.getMatcherList().end(); it++)
+      setShared(**it);
+
+    if(RegexMatcher::EXPR_COMPONENT_SET == matcher.getType())
+      {
+        const set<ptr_lib::shared_ptr<RegexComponentMatcher> >& components =
+          static_cast<RegexComponentSetMatcher&>(matcher).getComponents();
+        set<ptr_lib::shared_ptr<RegexComponentMatcher> >::const_iterator component = components.begin();
+        for(; component != components.end(); component++)
+          setShared(**component);
+      }
+  }
+
+}//ndn
@@ -0,0 +1,74 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_REGEX_SUBPATTERN_TABLE_H
+#define NDN_REGEX_SUBPATTERN_TABLE_H
+
+#include <string>
+
+#include "regex-matcher.hpp"
+
+namespace ndn
+{
+  /**
+   * @brief Table of the sub-pattern matchers shared by all expressions.
+   *
+   * Policies repeat the same sub-patterns, such as <KEY>, [^<KEY>]* or <ksk-.*>, in many
+   * rules.  A repeated component set without captures is compiled once and the matcher is
+   * shared by every expression containing it, which turns the matcher trees into a DAG.
+   * Shared matchers keep no match result, so expressions sharing them can still be matched
+   * concurrently, and their results on a name can be memoized (see RegexMatchMemo).
+   *
+   * The table only holds weak references, a sub-pattern is released with the last
+   * expression using it.  Every shared sub-pattern has a small memo id, the index of its
+   * results in a RegexMatchMemo; the ids of released sub-patterns are reused.
+   */
+  class RegexSubpatternTable
+  {
+  public:
+    /**
+     * @brief get the matcher of a repeated component set
+     * @param expr The expression, a component set followed by an optional repetition
+     * @param backrefManager The back reference manager of the enclosing expression
+     * @param indicator The position of the repetition in expr
+     * @returns the shared matcher, or a new matcher registered in backrefManager if the
+     *          components have marked sub-expressions
+     */
+    static ptr_lib::shared_ptr<RegexMatcher>
+    getRepeatMatcher(const std::string& expr,
+                     ptr_lib::shared_ptr<RegexBackrefManager> backrefManager,
+                     int indicator);
+
+    /**
+     * @brief get the number of sub-patterns currently shared
+     */
+    static size_t
+    size();
+
+    /**
+     * @brief get the number of memo ids (see RegexMatcher::getMemoId) in use or free;
+     *        every memo id is lower than it
+     */
+    static size_t
+    getMemoIdCount();
+
+  private:
+    friend class RegexMatcher;
+
+    /**
+     * @brief make the memo id of a released sub-pattern available to the next one
+     */
+    static void
+    releaseMemoId(size_t memoId);
+
+    static void
+    setShared(RegexMatcher& matcher);
+  };
+
+}//ndn
+
+#endif
@@ -0,0 +1,80 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include <string.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "regex-substring-searcher.hpp"
+
+#include "logging.h"
+
+INIT_LOGGER ("RegexSubstringSearcher");
+
+using namespace std;
+
+namespace ndn
+{
+  RegexSubstringSearcher::RegexSubstringSearcher(const string& needle)
+    : m_needle(needle)
+  {}
+
+  const uint8_t*
+  RegexSubstringSearcher::find(const uint8_t* haystack, size_t size) const
+  {
+    const uint8_t* needle = reinterpret_cast<const uint8_t*>(m_needle.data());
+    const size_t needleSize = m_needle.size();
+
+    if(0 == needleSize)
+      return haystack;
+    if(size < needleSize)
+      return 0;
+
+    // the first and the last byte are compared by the scan, only the middle is left to memcmp
+    const uint8_t first = needle[0];
+    const uint8_t last = needle[needleSize - 1];
+    const size_t middleSize = (needleSize > 2 ? needleSize - 2 : 0);
+    const size_t positions = size - needleSize + 1;
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    const __m128i firstBytes = _mm_set1_epi8(static_cast<char>(first));
+    const __m128i lastBytes = _mm_set1_epi8(static_cast<char>(last));
+
+    for(; i + 16 <= positions; i += 16)
+      {
+        __m128i blockFirst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i));
+        __m128i blockLast = _mm_loadu_si128(reinterpret_cast<const __m128i*>(haystack + i + needleSize - 1));
+        unsigned int mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, firstBytes),
+                                                            _mm_cmpeq_epi8(blockLast, lastBytes)));
+        while(0 != mask)
+          {
+            const uint8_t* candidate = haystack + i + __builtin_ctz(mask);
+            if(0 == memcmp(candidate + 1, needle + 1, middleSize))
+              return candidate;
+            mask &= mask - 1;
+          }
+      }
+#endif
+
+    while(i < positions)
+      {
+        const uint8_t* candidate = static_cast<const uint8_t*>(memchr(haystack + i, first, positions - i));
+        if(0 == candidate)
+          return 0;
+
+        if(last == candidate[needleSize - 1] && 0 == memcmp(candidate + 1, needle + 1, middleSize))
+          return candidate;
+
+        i = candidate - haystack + 1;
+      }
+
+    return 0;
+  }
+
+}//ndn
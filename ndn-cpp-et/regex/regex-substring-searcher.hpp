@@ -0,0 +1,47 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_REGEX_SUBSTRING_SEARCHER_H
+#define NDN_REGEX_SUBSTRING_SEARCHER_H
+
+#include <string>
+#include <stdint.h>
+
+namespace ndn
+{
+  /**
+   * @brief Find a fixed byte string in component values.
+   *
+   * Candidate positions are found by comparing the first and the last byte of the needle
+   * against 16 positions at a time (SSE2, or memchr where SSE2 is not available), and
+   * are then verified with memcmp.  Searching does not allocate.
+   */
+  class RegexSubstringSearcher
+  {
+  public:
+    RegexSubstringSearcher(const std::string& needle);
+
+    /**
+     * @brief find the first occurrence of the needle
+     * @param haystack The bytes to search
+     * @param size The number of bytes
+     * @returns the position of the occurrence, or 0 if there is none
+     */
+    const uint8_t*
+    find(const uint8_t* haystack, size_t size) const;
+
+    const std::string&
+    getNeedle() const
+    { return m_needle; }
+
+  private:
+    const std::string m_needle;
+  };
+
+}//ndn
+
+#endif
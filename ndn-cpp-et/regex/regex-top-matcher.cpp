@@ -5,10 +5,11 @@
  * See COPYING for copyright and distribution information.
  */
 
-#include <stdlib.h>
-
 #include "regex-top-matcher.hpp"
+#include "regex-literal-matcher.hpp"
+#include "regex-repeat-matcher.hpp"
 #include "regex-exception.hpp"
+#include "regex-match-trace.hpp"
 
 #include "logging.h"
 
@@ -22,17 +23,37 @@ namespace ndn
   RegexTopMatcher::RegexTopMatcher(const string & expr, const string & expand)
     : RegexMatcher(expr, EXPR_TOP),
       m_expand(expand),
-      m_secondaryUsed(false)
+      m_secondaryUsed(false),
+      m_nativeMatcher(RegexNativeRegistry::findMatcher(expr))
   {
     // _LOG_TRACE ("Enter RegexTopMatcher Constructor");
 
     m_primaryBackRefManager = ptr_lib::make_shared<RegexBackrefManager>();
     m_secondaryBackRefManager = ptr_lib::make_shared<RegexBackrefManager>();
     compile();
+    compileSuffix();
 
     // _LOG_TRACE ("Exit RegexTopMatcher Constructor");
   }
 
+  RegexTopMatcher::RegexTopMatcher(const string & expr,
+                                   const string & expand,
+                                   ptr_lib::shared_ptr<RegexPatternListMatcher> primaryMatcher,
+                                   ptr_lib::shared_ptr<RegexBackrefManager> primaryBackRefManager,
+                                   ptr_lib::shared_ptr<RegexPatternListMatcher> secondaryMatcher,
+                                   ptr_lib::shared_ptr<RegexBackrefManager> secondaryBackRefManager)
+    : RegexMatcher(expr, EXPR_TOP),
+      m_expand(expand),
+      m_primaryMatcher(primaryMatcher),
+      m_secondaryMatcher(secondaryMatcher),
+      m_primaryBackRefManager(primaryBackRefManager),
+      m_secondaryBackRefManager(secondaryBackRefManager),
+      m_secondaryUsed(false),
+      m_nativeMatcher(RegexNativeRegistry::findMatcher(expr))
+  {
+    compileSuffix();
+  }
+
   RegexTopMatcher::~RegexTopMatcher()
   {
     // delete m_backRefManager;
@@ -65,14 +86,80 @@ namespace ndn
     // _LOG_TRACE ("Exit RegexTopMatcher::compile");
   }
 
+  void
+  RegexTopMatcher::compileSuffix()
+  {
+    m_suffixMatchers.clear();
+
+    if(!static_cast<bool>(m_primaryMatcher) || '$' != m_expr[m_expr.size() - 1])
+      return;
+
+    // Collect the trailing single components of an anchored expression, last one first.
+    // They must match the last components of any matching name, whatever comes before them.
+    const vector<ptr_lib::shared_ptr<RegexMatcher> >& matcherList = m_primaryMatcher->getMatcherList();
+    vector<ptr_lib::shared_ptr<RegexMatcher> >::const_reverse_iterator it = matcherList.rbegin();
+    for(; it != matcherList.rend(); it++)
+      {
+        if(EXPR_REPEAT_PATTERN != (*it)->getType())
+          break;
+
+        const RegexRepeatMatcher& repeat = static_cast<const RegexRepeatMatcher&>(**it);
+        if(repeat.getRepeatMin() != repeat.getRepeatMax() ||
+           EXPR_COMPONENT_SET != repeat.getMatcherList()[0]->getType())
+          break;
+
+        for(int i = 0; i < repeat.getRepeatMin(); i++)
+          m_suffixMatchers.push_back(repeat.getMatcherList()[0]);
+      }
+  }
+
+  bool
+  RegexTopMatcher::matchSuffix(const RegexNameView & name)
+  {
+    if(name.size() < m_suffixMatchers.size())
+      return false;
+
+    int offset = name.size() - 1;
+    vector<ptr_lib::shared_ptr<RegexMatcher> >::iterator it = m_suffixMatchers.begin();
+    for(; it != m_suffixMatchers.end(); it++, offset--)
+      {
+        if(!(*it)->match(name, offset, 1))
+          return false;
+      }
+    return true;
+  }
+
   bool 
-  RegexTopMatcher::match(const Name & name)
+  RegexTopMatcher::match(const RegexNameView & name)
   {
     // _LOG_DEBUG("Enter RegexTopMatcher::match");
+    REGEX_TRACE_MATCH(this);
 
     m_secondaryUsed = false;
 
-    m_matchResult.clear();
+    resetMatchResult();
+
+    // a back reference the match does not go through, e.g. in (<a>)*, must not keep the
+    // result of the previous name
+    resetBackRefs(*m_primaryBackRefManager);
+    resetBackRefs(*m_secondaryBackRefManager);
+
+    if(0 != m_nativeMatcher)
+      {
+        if(!m_nativeMatcher(name))
+          return false;
+
+        // back references are only collected by the interpreted matchers
+        if(0 == m_primaryBackRefManager->size())
+          {
+            m_matchResult.reserve(name.size());
+            for(size_t i = 0; i < name.size(); i++)
+              m_matchResult.push_back(name.get(i));
+            return true;
+          }
+      }
+    else if(!m_suffixMatchers.empty() && !matchSuffix(name))
+      return false;
 
     if(m_primaryMatcher->match(name, 0, name.size()))
       {
@@ -92,11 +179,28 @@ namespace ndn
   }
   
   bool 
-  RegexTopMatcher::match (const Name & name, const int & offset, const int & len)
+  RegexTopMatcher::match (const RegexNameView & name, const int & offset, const int & len)
   {
     return match(name);
   }
 
+  bool
+  RegexTopMatcher::match (const RegexNameView & name, RegexMatchTrace & trace)
+  {
+    trace.start(*this);
+
+    bool matched = false;
+    try{
+      matched = match(name);
+    }catch(...){
+      trace.finish(false);
+      throw;
+    }
+
+    trace.finish(matched);
+    return matched;
+  }
+
   Name 
   RegexTopMatcher::expand (const string & expandStr)
   {
@@ -104,113 +208,79 @@ namespace ndn
 
     Name result;
     
-    ptr_lib::shared_ptr<RegexBackrefManager> backRefManager = (m_secondaryUsed ? m_secondaryBackRefManager : m_primaryBackRefManager);
-    
-    int backRefNum = backRefManager->size();
-
-    string expand;
-    
-    if(expandStr != "")
-      expand = expandStr;
-    else
-      expand = m_expand;
-
-    int offset = 0;
-    while(offset < expand.size())
+    RegexExpandPattern pattern(expandStr != "" ? expandStr : m_expand);
+    for(size_t i = 0; i < pattern.size(); i++)
       {
-        string item = getItemFromExpand(expand, offset);
-        if(item[0] == '<')
+        if(!pattern.isBackRef(i))
           {
-            result.append(item.substr(1, item.size() - 2));
+            result.append(pattern.getValue(i));
+            continue;
           }
-        if(item[0] == '\\')
-          {
 
-            int index = atoi(item.substr(1, item.size() - 1).c_str());
-
-            if(0 == index){
-              vector<Name::Component>::iterator it = m_matchResult.begin();
-              vector<Name::Component>::iterator end = m_matchResult.end();
-              for(; it != end; it++)
-                    result.append (*it);
-            }
-            else if(index <= backRefNum)
-              {
-                vector<Name::Component>::const_iterator it = backRefManager->getBackRef (index - 1)->getMatchResult ().begin();
-                vector<Name::Component>::const_iterator end = backRefManager->getBackRef (index - 1)->getMatchResult ().end();
-                for(; it != end; it++)
-                    result.append (*it);
-              }
-            else
-              throw RegexException("Exceed the range of back reference!");
-          }   
+        const vector<Name::Component>& components = getBackRefResult(pattern.getBackRef(i)).getMatchResult();
+        vector<Name::Component>::const_iterator it = components.begin();
+        for(; it != components.end(); it++)
+          result.append (*it);
       }
     return result;
   }
 
-  string
-  RegexTopMatcher::getItemFromExpand(const string & expand, int & offset)
+  void
+  RegexTopMatcher::expand (const RegexExpandPattern & pattern,
+                           const RegexNameView & name,
+                           RegexExpandPattern::ValueList & values)
   {
-    // _LOG_TRACE("Enter RegexTopMatcher::getItemFromExpand ");
-    int begin = offset;
-
-    if(expand[offset] == '\\')
-      {
-        offset++;
-        if(offset >= expand.size())
-          throw RegexException("wrong format of expand string!");
-
-        while(expand[offset] <= '9' and expand[offset] >= '0'){
-          offset++;
-          if(offset > expand.size())
-            throw RegexException("wrong format of expand string!");
-        }
-        if(offset > begin + 1)
-          return expand.substr(begin, offset - begin);
-        else
-          throw RegexException("wrong format of expand string!");
-    }
-    else if(expand[offset] == '<')
+    values.clear();
+    for(size_t i = 0; i < pattern.size(); i++)
       {
-        offset++;
-        if(offset >= expand.size())
-          throw RegexException("wrong format of expand string!");
-        
-        int left = 1;
-        int right = 0;
-        while(right < left)
+        if(!pattern.isBackRef(i))
+          {
+            const string& value = pattern.getValue(i);
+            values.push_back(make_pair(reinterpret_cast<const uint8_t*>(value.data()), value.size()));
+            continue;
+          }
+
+        const RegexMatcher& backRef = getBackRefResult(pattern.getBackRef(i));
+        if(EXPR_PSEUDO == backRef.getType())
           {
-            if(expand[offset] == '<')
-              left++;
-            if(expand[offset] == '>')
-              right++;            
-            offset++;
-            if(offset >= expand.size())
-              throw RegexException("wrong format of expand string!");
+            // a back reference inside a component regex holds a part of a component
+            const vector<Name::Component>& components = backRef.getMatchResult();
+            for(size_t j = 0; j < components.size(); j++)
+              values.push_back(make_pair(components[j].value(), components[j].value_size()));
+            continue;
           }
-        return expand.substr(begin, offset - begin);
+
+        // any other back reference is a span of the matched name, its values are read in place
+        int end = backRef.getMatchOffset() + backRef.getMatchResult().size();
+        for(int j = backRef.getMatchOffset(); j < end; j++)
+          values.push_back(make_pair(name.getValue(j), name.getValueSize(j)));
       }
-    else
-      throw RegexException("wrong format of expand string!");
   }
 
-  ptr_lib::shared_ptr<RegexTopMatcher>
-  RegexTopMatcher::fromName(const Name& name, bool hasAnchor)
+  void
+  RegexTopMatcher::resetBackRefs(RegexBackrefManager & backRefManager)
   {
-    Name::const_iterator it = name.begin();
-    string regexStr("^");
-    
-    for(; it != name.end(); it++)
-      {
-	regexStr.append("<");
-	regexStr.append(convertSpecialChar(it->toEscapedString()));
-	regexStr.append(">");
-      }
+    for(int i = 0; i < backRefManager.size(); i++)
+      backRefManager.getBackRef(i)->resetMatchResult();
+  }
 
-    if(hasAnchor)
-      regexStr.append("$");
+  const RegexMatcher&
+  RegexTopMatcher::getBackRefResult(int index)
+  {
+    if(0 == index)
+      return *this;
+
+    RegexBackrefManager& backRefManager = (m_secondaryUsed ? *m_secondaryBackRefManager : *m_primaryBackRefManager);
+    if(index > backRefManager.size())
+      throw RegexException("Exceed the range of back reference!");
+
+    return *backRefManager.getBackRef(index - 1);
+  }
 
-    return ptr_lib::make_shared<RegexTopMatcher>(regexStr);
+  ptr_lib::shared_ptr<RegexTopMatcher>
+  RegexTopMatcher::fromName(const Name& name, bool hasAnchor)
+  {
+    return ptr_lib::make_shared<RegexLiteralMatcher>(name, hasAnchor);
   }
 
   string
@@ -12,6 +12,9 @@
 
 #include "regex-matcher.hpp"
 #include "regex-pattern-list-matcher.hpp"
+#include "regex-native-registry.hpp"
+#include "regex-match-trace.hpp"
+#include "regex-expand-pattern.hpp"
 
 namespace ndn
 {
@@ -19,32 +22,136 @@ namespace ndn
   {
   public:
     RegexTopMatcher(const std::string & expr, const std::string & expand = "");
+
+    /**
+     * @brief Create a RegexTopMatcher from already compiled matchers, see RegexProgram
+     * @param expr The expression the matchers were compiled from
+     * @param expand The default expand string
+     * @param primaryMatcher The compiled primary pattern list
+     * @param primaryBackRefManager The back references of primaryMatcher
+     * @param secondaryMatcher The compiled secondary pattern list, NULL if expr starts with '^'
+     * @param secondaryBackRefManager The back references of secondaryMatcher
+     */
+    RegexTopMatcher(const std::string & expr,
+                    const std::string & expand,
+                    ptr_lib::shared_ptr<RegexPatternListMatcher> primaryMatcher,
+                    ptr_lib::shared_ptr<RegexBackrefManager> primaryBackRefManager,
+                    ptr_lib::shared_ptr<RegexPatternListMatcher> secondaryMatcher,
+                    ptr_lib::shared_ptr<RegexBackrefManager> secondaryBackRefManager);
     
     virtual ~RegexTopMatcher();
 
-    bool 
-    match(const Name & name);
+    /**
+     * @brief match a name, which can be a Name or a wire-encoded Name TLV (Block)
+     * @param name The name to match
+     * @returns true if the name matches the expression
+     */
+    virtual bool
+    match(const RegexNameView & name);
+
+    /**
+     * @brief match a wire-encoded Name TLV in place, without decoding it into a Name
+     * @param wire The Name TLV
+     * @param size The size of the Name TLV
+     * @throws RegexException if the buffer does not hold a well-formed Name TLV
+     */
+    bool
+    match(const uint8_t* wire, size_t size)
+    { return match(RegexNameView(wire, size)); }
 
     virtual bool
-    match (const Name & name, const int & offset, const int & len);
+    match (const RegexNameView & name, const int & offset, const int & len);
+
+    /**
+     * @brief match a name and collect the invocations, backtracks and component regex
+     *        evaluations of the matchers in trace (see RegexMatchTrace)
+     */
+    bool
+    match (const RegexNameView & name, RegexMatchTrace & trace);
 
     virtual Name 
     expand (const std::string & expand = "");
 
+    /**
+     * @brief expand the last match without building a Name
+     * @param pattern The parsed expand string
+     * @param name The name of the last successful match
+     * @param values Receives the values of the expanded components, they point into name
+     *        and pattern, which must outlive them
+     * @throws RegexException if a back reference is out of range
+     */
+    void
+    expand (const RegexExpandPattern & pattern,
+            const RegexNameView & name,
+            RegexExpandPattern::ValueList & values);
+
+    /**
+     * @brief create a matcher of a literal name prefix, see RegexLiteralMatcher
+     * @param name The prefix
+     * @param hasAnchor true if the whole name must be equal to the prefix
+     */
     static ptr_lib::shared_ptr<RegexTopMatcher>
     fromName(const Name& name, bool hasAnchor=false);
 
+    const std::string&
+    getExpand() const
+    { return m_expand; }
+
+    ptr_lib::shared_ptr<RegexPatternListMatcher>
+    getPrimaryMatcher() const
+    { return m_primaryMatcher; }
+
+    ptr_lib::shared_ptr<RegexBackrefManager>
+    getPrimaryBackRefManager() const
+    { return m_primaryBackRefManager; }
+
+    /**
+     * @brief get the matcher used when the expression is not anchored by '^'
+     * @returns the secondary matcher, NULL if the expression starts with '^'
+     */
+    ptr_lib::shared_ptr<RegexPatternListMatcher>
+    getSecondaryMatcher() const
+    { return m_secondaryMatcher; }
+
+    ptr_lib::shared_ptr<RegexBackrefManager>
+    getSecondaryBackRefManager() const
+    { return m_secondaryBackRefManager; }
+
+    /**
+     * @brief check if a native matcher from RegexNativeRegistry is used
+     */
+    bool
+    isNative() const
+    { return 0 != m_nativeMatcher; }
+
   protected:
     virtual void 
     compile();
 
-  private:
-    std::string
-    getItemFromExpand(const std::string & expand, int & offset);
-
     static std::string
     convertSpecialChar(const std::string& str);
 
+  private:
+    /**
+     * @brief collect the fixed-length suffix of a '$'-anchored expression, which is checked
+     *        from the end of the name before running the matchers
+     */
+    void
+    compileSuffix();
+
+    bool
+    matchSuffix(const RegexNameView & name);
+
+    /**
+     * @brief get the matcher holding the components of a back reference of the last match
+     * @param index The back reference, 0 for the whole match
+     */
+    const RegexMatcher&
+    getBackRefResult(int index);
+
+    static void
+    resetBackRefs(RegexBackrefManager & backRefManager);
+
   private:
     const std::string m_expand;
     ptr_lib::shared_ptr<RegexPatternListMatcher> m_primaryMatcher;
@@ -52,6 +159,8 @@ namespace ndn
     ptr_lib::shared_ptr<RegexBackrefManager> m_primaryBackRefManager;
     ptr_lib::shared_ptr<RegexBackrefManager> m_secondaryBackRefManager;
     bool m_secondaryUsed;
+    RegexNativeMatcher m_nativeMatcher;
+    std::vector<ptr_lib::shared_ptr<RegexMatcher> > m_suffixMatchers;
   };
 
 }
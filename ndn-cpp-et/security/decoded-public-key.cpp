@@ -0,0 +1,232 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include "decoded-public-key.hpp"
+
+#include <cryptopp/queue.h>
+#include <cryptopp/rsa.h>
+#include <cryptopp/sha.h>
+
+#include <string.h>
+#include <vector>
+
+#include "logging.h"
+
+INIT_LOGGER ("DecodedPublicKey");
+
+using namespace std;
+
+namespace ndn
+{
+
+// DER encoding of the DigestInfo of a SHA-256 digest, which precedes the digest (RFC 3447, 9.2)
+static const uint8_t SHA256_DIGEST_INFO[] = {
+  0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04, 0x20
+};
+
+// DER encoding of the rsaEncryption algorithm OID (RFC 3279, 2.3.1)
+static const uint8_t RSA_ENCRYPTION_OID[] = {
+  0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x01
+};
+
+// decoded in the initializer list, the Montgomery context is built on the modulus
+static CryptoPP::Integer
+decodeRsaKey(const PublicKey& publicKey, CryptoPP::Integer& exponent)
+{
+  try{
+    CryptoPP::RSA::PublicKey rsaKey;
+    CryptoPP::ByteQueue queue;
+    queue.Put(publicKey.get().buf(), publicKey.get().size());
+    rsaKey.Load(queue);
+    exponent = rsaKey.GetPublicExponent();
+    return rsaKey.GetModulus();
+  }catch(CryptoPP::Exception &e){
+    throw DecodedPublicKey::Error(string("cannot decode RSA public key: ") + e.what());
+  }
+}
+
+DecodedPublicKey::DecodedPublicKey(const PublicKey& publicKey)
+  : m_modulus(decodeRsaKey(publicKey, m_exponent))
+  , m_modulusSize(m_modulus.ByteCount())
+  , m_montgomery(m_modulus)
+{}
+
+ptr_lib::shared_ptr<const DecodedPublicKey>
+DecodedPublicKey::decode(const PublicKey& publicKey)
+{
+  if(!isRsaKey(publicKey))
+    return ptr_lib::shared_ptr<const DecodedPublicKey>();
+
+  try{
+    return ptr_lib::make_shared<DecodedPublicKey>(publicKey);
+  }catch(Error &e){
+    _LOG_DEBUG("DecodedPublicKey: " << e.what());
+    return ptr_lib::shared_ptr<const DecodedPublicKey>();
+  }
+}
+
+// skips the header of a DER SEQUENCE, false if p does not start with one
+static bool
+skipSequenceHeader(const uint8_t*& p, const uint8_t* end)
+{
+  if(end - p < 2 || 0x30 != p[0])
+    return false;
+
+  // short form, or long form with up to 4 length bytes
+  size_t lengthSize = (p[1] < 0x80 ? 0 : p[1] & 0x7f);
+  if(lengthSize > 4 || static_cast<size_t>(end - p) < 2 + lengthSize)
+    return false;
+  p += 2 + lengthSize;
+  return true;
+}
+
+bool
+DecodedPublicKey::isRsaKey(const PublicKey& publicKey)
+{
+  // SubjectPublicKeyInfo ::= SEQUENCE { algorithm SEQUENCE { algorithm OID, ... }, ... }
+  const uint8_t* p = publicKey.get().buf();
+  const uint8_t* end = p + publicKey.get().size();
+  if(!skipSequenceHeader(p, end) || !skipSequenceHeader(p, end))
+    return false;
+
+  return static_cast<size_t>(end - p) >= sizeof(RSA_ENCRYPTION_OID)
+    && 0 == memcmp(p, RSA_ENCRYPTION_OID, sizeof(RSA_ENCRYPTION_OID));
+}
+
+bool
+DecodedPublicKey::verifySignature(const Data& data, const Signature& signature) const
+{
+  return verifySignature(data.wireEncode(), signature);
+}
+
+bool
+DecodedPublicKey::verifySignature(const Block& wire, const Signature& signature) const
+{
+  if(Signature::Sha256WithRsa != signature.getType())
+    return false;
+
+  const uint8_t* buf = 0;
+  size_t size = 0;
+  const uint8_t* sig = 0;
+  size_t sigSize = 0;
+  if(!parseSignedWire(wire, buf, size, sig, sigSize))
+    return false;
+
+  return verifySignature(buf, size, sig, sigSize);
+}
+
+bool
+DecodedPublicKey::verifyDigest(const Block& wire, const Signature& signature, const uint8_t* digest) const
+{
+  if(Signature::Sha256WithRsa != signature.getType())
+    return false;
+
+  const uint8_t* buf = 0;
+  size_t size = 0;
+  const uint8_t* sig = 0;
+  size_t sigSize = 0;
+  if(!parseSignedWire(wire, buf, size, sig, sigSize))
+    return false;
+
+  return verifyDigest(digest, sig, sigSize);
+}
+
+bool
+DecodedPublicKey::computeDigest(const Block& wire, uint8_t* digest)
+{
+  const uint8_t* buf = 0;
+  size_t size = 0;
+  const uint8_t* sig = 0;
+  size_t sigSize = 0;
+  if(!parseSignedWire(wire, buf, size, sig, sigSize))
+    return false;
+
+  CryptoPP::SHA256().CalculateDigest(digest, buf, size);
+  return true;
+}
+
+bool
+DecodedPublicKey::parseSignedWire(const Block& wire, const uint8_t*& buf, size_t& size,
+                                  const uint8_t*& sig, size_t& sigSize)
+{
+  if(!wire.hasWire())
+    return false;
+
+  // walk the elements instead of Block::parse, which would fill the element list of a
+  // block shared with other threads
+  const uint8_t* begin = wire.value();
+  const uint8_t* end = begin + wire.value_size();
+  const uint8_t* element = begin;
+  try{
+    while(element < end)
+      {
+        const uint8_t* value = element;
+        uint32_t type = Tlv::readType(value, end);
+        uint64_t length = Tlv::readVarNumber(value, end);
+        if(length > static_cast<uint64_t>(end - value))
+          return false;
+
+        if(Tlv::SignatureValue == type)
+          {
+            buf = begin;
+            size = element - begin;
+            sig = value;
+            sigSize = length;
+            return true;
+          }
+        element = value + length;
+      }
+  }catch(Tlv::Error &e){
+    return false;
+  }
+  return false;
+}
+
+bool
+DecodedPublicKey::verifySignature(const uint8_t* buf, size_t size, const uint8_t* sig, size_t sigSize) const
+{
+  uint8_t digest[CryptoPP::SHA256::DIGESTSIZE];
+  CryptoPP::SHA256 hash;
+  hash.Update(buf, size);
+  hash.Final(digest);
+
+  return verifyDigest(digest, sig, sigSize);
+}
+
+bool
+DecodedPublicKey::verifyDigest(const uint8_t* digest, const uint8_t* sig, size_t sigSize) const
+{
+  const size_t digestInfoSize = sizeof(SHA256_DIGEST_INFO) + CryptoPP::SHA256::DIGESTSIZE;
+  // 0x00 0x01, at least 8 bytes of 0xFF, 0x00, DigestInfo
+  if(sigSize != m_modulusSize || m_modulusSize < digestInfoSize + 11)
+    return false;
+
+  CryptoPP::Integer signature(sig, sigSize);
+  if(signature >= m_modulus)
+    return false;
+
+  // the copy carries the context of the modulus and a workspace of this call only
+  CryptoPP::MontgomeryRepresentation montgomery(m_montgomery);
+  CryptoPP::Integer message = montgomery.ConvertOut(montgomery.Exponentiate(montgomery.ConvertIn(signature), m_exponent));
+
+  vector<uint8_t> encoded(m_modulusSize);
+  message.Encode(&encoded[0], m_modulusSize);
+
+  size_t paddingEnd = m_modulusSize - digestInfoSize - 1;
+  if(0x00 != encoded[0] || 0x01 != encoded[1] || 0x00 != encoded[paddingEnd])
+    return false;
+  for(size_t i = 2; i < paddingEnd; i++)
+    if(0xFF != encoded[i])
+      return false;
+
+  if(0 != memcmp(&encoded[paddingEnd + 1], SHA256_DIGEST_INFO, sizeof(SHA256_DIGEST_INFO)))
+    return false;
+
+  return 0 == memcmp(&encoded[m_modulusSize - CryptoPP::SHA256::DIGESTSIZE], digest, CryptoPP::SHA256::DIGESTSIZE);
+}
+
+}//ndn
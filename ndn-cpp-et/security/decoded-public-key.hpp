@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_DECODED_PUBLIC_KEY_HPP
+#define NDN_DECODED_PUBLIC_KEY_HPP
+
+#include <ndn-cpp-dev/data.hpp>
+#include <ndn-cpp-dev/security/public-key.hpp>
+
+#include <cryptopp/integer.h>
+#include <cryptopp/modarith.h>
+#include <cryptopp/sha.h>
+
+namespace ndn
+{
+
+/**
+ * @brief An RSA public key decoded once, ready to verify SHA256withRSA signatures.
+ *
+ * Verifier::verifySignature decodes the key and sets up a CryptoPP verifier for every
+ * signature.  A DecodedPublicKey keeps the modulus, the exponent and the Montgomery
+ * context of the modulus, and checks the PKCS#1 v1.5 encoding of the SHA-256 digest
+ * itself, so a verification is one modular exponentiation and one hash, and the hash can
+ * be computed ahead of the exponentiation (computeDigest, verifyDigest).  Both read the
+ * received wire encoding in place.  A decoded key is not modified by a verification, it
+ * can be shared by threads without locking.
+ */
+class DecodedPublicKey
+{
+public:
+  struct Error : public std::runtime_error { Error(const std::string &what) : std::runtime_error(what) {} };
+
+  /**
+   * @brief decode a public key
+   * @param publicKey The SubjectPublicKeyInfo of an RSA key
+   * @throws Error if the key cannot be decoded as an RSA key
+   */
+  explicit
+  DecodedPublicKey(const PublicKey& publicKey);
+
+  /**
+   * @brief decode a public key if it is of a type DecodedPublicKey verifies with
+   *
+   * The key type is read from the algorithm of the SubjectPublicKeyInfo, a key of another
+   * type (e.g. an EC key) is not handed to the RSA decoder.
+   * @returns the decoded key, NULL if the key is not an RSA key or cannot be decoded
+   */
+  static ptr_lib::shared_ptr<const DecodedPublicKey>
+  decode(const PublicKey& publicKey);
+
+  /**
+   * @brief check if a SubjectPublicKeyInfo is an RSA key, without decoding it
+   */
+  static bool
+  isRsaKey(const PublicKey& publicKey);
+
+  /**
+   * @brief check if the key verifies signatures of a type, see Signature::getType
+   */
+  bool
+  canVerify(uint32_t signatureType) const
+  { return Signature::Sha256WithRsa == signatureType; }
+
+  /**
+   * @brief verify the SHA256withRSA signature of a data packet
+   * @returns false if the signature is not SHA256withRSA or does not match
+   */
+  bool
+  verifySignature(const Data& data, const Signature& signature) const;
+
+  /**
+   * @brief verify the SHA256withRSA signature of a data packet in its wire encoding, the
+   *        signed portion and the signature bits are read in place
+   * @param wire The Data TLV
+   * @param signature The signature of the packet, for its type
+   * @returns false if the signature is not SHA256withRSA, wire has no SignatureValue, or
+   *          the signature does not match
+   */
+  bool
+  verifySignature(const Block& wire, const Signature& signature) const;
+
+  /**
+   * @brief verify a PKCS#1 v1.5 SHA256withRSA signature
+   * @param buf The signed bytes
+   * @param size The number of signed bytes
+   * @param sig The signature
+   * @param sigSize The size of the signature
+   */
+  bool
+  verifySignature(const uint8_t* buf, size_t size, const uint8_t* sig, size_t sigSize) const;
+
+  /**
+   * @brief verify a PKCS#1 v1.5 SHA256withRSA signature of a digest computed beforehand
+   * @param digest The SHA-256 digest of the signed bytes, CryptoPP::SHA256::DIGESTSIZE bytes
+   * @param sig The signature
+   * @param sigSize The size of the signature
+   */
+  bool
+  verifyDigest(const uint8_t* digest, const uint8_t* sig, size_t sigSize) const;
+
+  /**
+   * @brief verify the SHA256withRSA signature of a data packet whose signed portion has been
+   *        hashed beforehand, see computeDigest
+   * @param wire The Data TLV, the signature bits are read in place
+   * @param signature The signature of the packet, for its type
+   * @returns false if the signature is not SHA256withRSA or does not match
+   */
+  bool
+  verifyDigest(const Block& wire, const Signature& signature, const uint8_t* digest) const;
+
+  /**
+   * @brief compute the SHA-256 digest of the signed portion of a data packet
+   * @param wire The Data TLV
+   * @param digest Set to the digest, CryptoPP::SHA256::DIGESTSIZE bytes
+   * @returns false if wire has no SignatureValue
+   */
+  static bool
+  computeDigest(const Block& wire, uint8_t* digest);
+
+  /**
+   * @brief find the signed portion and the signature bits in the wire encoding of a data
+   *        packet, the signed portion is the value of the Data TLV up to the SignatureValue TLV
+   *
+   * Both point into wire, nothing is decoded, copied or encoded again.
+   * @returns false if wire has no SignatureValue
+   */
+  static bool
+  parseSignedWire(const Block& wire, const uint8_t*& buf, size_t& size, const uint8_t*& sig, size_t& sigSize);
+
+  size_t
+  getModulusSize() const
+  { return m_modulusSize; }
+
+private:
+  DecodedPublicKey(const DecodedPublicKey&);
+
+  DecodedPublicKey&
+  operator=(const DecodedPublicKey&);
+
+private:
+  CryptoPP::Integer m_exponent;
+  CryptoPP::Integer m_modulus;
+  size_t m_modulusSize;
+  // never used directly: Exponentiate() writes a workspace inside the representation,
+  // verifyDigest works on a copy so that a key is read-only once decoded
+  CryptoPP::MontgomeryRepresentation m_montgomery;
+};
+
+}//ndn
+
+#endif
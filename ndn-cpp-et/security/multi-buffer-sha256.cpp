@@ -0,0 +1,343 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include "multi-buffer-sha256.hpp"
+
+#include <cryptopp/sha.h>
+
+#include <string.h>
+#include <algorithm>
+#include <vector>
+
+// the AVX2 kernel is compiled with a target attribute and chosen at run time, so that a
+// default x86 build uses it on the CPUs that have it
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NDN_SHA256_HAS_AVX2_KERNEL 1
+#define NDN_SHA256_AVX2 __attribute__((target("avx2")))
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+#include "logging.h"
+
+INIT_LOGGER ("MultiBufferSha256");
+
+using namespace std;
+
+namespace ndn
+{
+
+const size_t MultiBufferSha256::DIGEST_SIZE;
+
+#if defined(NDN_SHA256_HAS_AVX2_KERNEL)
+
+static const uint32_t SHA256_K[64] = {
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t SHA256_H0[8] = {
+  0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+struct Sha256Lanes
+{
+  typedef __m256i Vector;
+  static const size_t COUNT = 8;
+
+  NDN_SHA256_AVX2 static Vector load(const uint32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+  NDN_SHA256_AVX2 static void store(uint32_t* p, Vector x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+  NDN_SHA256_AVX2 static Vector set1(uint32_t x) { return _mm256_set1_epi32(static_cast<int>(x)); }
+  NDN_SHA256_AVX2 static Vector add(Vector x, Vector y) { return _mm256_add_epi32(x, y); }
+  NDN_SHA256_AVX2 static Vector bitAnd(Vector x, Vector y) { return _mm256_and_si256(x, y); }
+  // ~x & y
+  NDN_SHA256_AVX2 static Vector bitAndNot(Vector x, Vector y) { return _mm256_andnot_si256(x, y); }
+  NDN_SHA256_AVX2 static Vector bitXor(Vector x, Vector y) { return _mm256_xor_si256(x, y); }
+  NDN_SHA256_AVX2 static Vector shr(Vector x, int n) { return _mm256_srli_epi32(x, n); }
+  NDN_SHA256_AVX2 static Vector rotr(Vector x, int n) { return _mm256_or_si256(_mm256_srli_epi32(x, n), _mm256_slli_epi32(x, 32 - n)); }
+};
+
+const size_t Sha256Lanes::COUNT;
+
+typedef Sha256Lanes Lanes;
+typedef Lanes::Vector Vector;
+
+/**
+ * @brief a buffer split in blocks, the last one or two blocks are padded in m_tail
+ */
+struct Sha256Message
+{
+  void
+  reset(const uint8_t* buffer, size_t size, uint8_t* digest)
+  {
+    m_buffer = buffer;
+    m_fullBlockCount = size / 64;
+    m_digest = digest;
+
+    size_t tailSize = size % 64;
+    m_blockCount = m_fullBlockCount + (tailSize + 9 <= 64 ? 1 : 2);
+    memset(m_tail, 0, sizeof(m_tail));
+    memcpy(m_tail, buffer + m_fullBlockCount * 64, tailSize);
+    m_tail[tailSize] = 0x80;
+
+    // the length in bits, big-endian, ends the last block
+    uint64_t bitCount = static_cast<uint64_t>(size) * 8;
+    uint8_t* end = m_tail + (m_blockCount - m_fullBlockCount) * 64;
+    for(int i = 1; i <= 8; i++, bitCount >>= 8)
+      end[-i] = static_cast<uint8_t>(bitCount);
+  }
+
+  const uint8_t*
+  getBlock(size_t block) const
+  {
+    if(block < m_fullBlockCount)
+      return m_buffer + block * 64;
+    return m_tail + (block - m_fullBlockCount) * 64;
+  }
+
+  const uint8_t* m_buffer;
+  size_t m_fullBlockCount;
+  size_t m_blockCount;
+  uint8_t m_tail[128];
+  uint8_t* m_digest;
+};
+
+NDN_SHA256_AVX2 static inline Vector
+bigSigma0(Vector x)
+{ return Lanes::bitXor(Lanes::bitXor(Lanes::rotr(x, 2), Lanes::rotr(x, 13)), Lanes::rotr(x, 22)); }
+
+NDN_SHA256_AVX2 static inline Vector
+bigSigma1(Vector x)
+{ return Lanes::bitXor(Lanes::bitXor(Lanes::rotr(x, 6), Lanes::rotr(x, 11)), Lanes::rotr(x, 25)); }
+
+NDN_SHA256_AVX2 static inline Vector
+smallSigma0(Vector x)
+{ return Lanes::bitXor(Lanes::bitXor(Lanes::rotr(x, 7), Lanes::rotr(x, 18)), Lanes::shr(x, 3)); }
+
+NDN_SHA256_AVX2 static inline Vector
+smallSigma1(Vector x)
+{ return Lanes::bitXor(Lanes::bitXor(Lanes::rotr(x, 17), Lanes::rotr(x, 19)), Lanes::shr(x, 10)); }
+
+// one block of every lane, words[t] holds word t of the block of each lane
+NDN_SHA256_AVX2 static void
+compress(Vector* state, const uint32_t words[16][Lanes::COUNT])
+{
+  Vector w[64];
+  for(int t = 0; t < 16; t++)
+    w[t] = Lanes::load(words[t]);
+  for(int t = 16; t < 64; t++)
+    w[t] = Lanes::add(Lanes::add(smallSigma1(w[t - 2]), w[t - 7]), Lanes::add(smallSigma0(w[t - 15]), w[t - 16]));
+
+  Vector a = state[0], b = state[1], c = state[2], d = state[3];
+  Vector e = state[4], f = state[5], g = state[6], h = state[7];
+  for(int t = 0; t < 64; t++)
+    {
+      Vector choose = Lanes::bitXor(Lanes::bitAnd(e, f), Lanes::bitAndNot(e, g));
+      Vector t1 = Lanes::add(Lanes::add(Lanes::add(h, bigSigma1(e)), Lanes::add(choose, w[t])),
+                             Lanes::set1(SHA256_K[t]));
+      Vector majority = Lanes::bitXor(Lanes::bitXor(Lanes::bitAnd(a, b), Lanes::bitAnd(a, c)), Lanes::bitAnd(b, c));
+      Vector t2 = Lanes::add(bigSigma0(a), majority);
+      h = g;
+      g = f;
+      f = e;
+      e = Lanes::add(d, t1);
+      d = c;
+      c = b;
+      b = a;
+      a = Lanes::add(t1, t2);
+    }
+
+  state[0] = Lanes::add(state[0], a);
+  state[1] = Lanes::add(state[1], b);
+  state[2] = Lanes::add(state[2], c);
+  state[3] = Lanes::add(state[3], d);
+  state[4] = Lanes::add(state[4], e);
+  state[5] = Lanes::add(state[5], f);
+  state[6] = Lanes::add(state[6], g);
+  state[7] = Lanes::add(state[7], h);
+}
+
+// a lane whose buffer is done, or which has no buffer, hashes zeros until the pass ends
+NDN_SHA256_AVX2 static void
+digestLanes(const Sha256Message* messages, size_t laneCount)
+{
+  static const uint8_t ZERO_BLOCK[64] = {0};
+
+  Vector state[8];
+  for(int i = 0; i < 8; i++)
+    state[i] = Lanes::set1(SHA256_H0[i]);
+
+  size_t blockCount = 0;
+  for(size_t lane = 0; lane < laneCount; lane++)
+    blockCount = max(blockCount, messages[lane].m_blockCount);
+
+  uint32_t words[16][Lanes::COUNT];
+  uint32_t laneState[8][Lanes::COUNT];
+  for(size_t block = 0; block < blockCount; block++)
+    {
+      for(size_t lane = 0; lane < Lanes::COUNT; lane++)
+        {
+          const uint8_t* p = ZERO_BLOCK;
+          if(lane < laneCount && block < messages[lane].m_blockCount)
+            p = messages[lane].getBlock(block);
+          for(int t = 0; t < 16; t++, p += 4)
+            words[t][lane] = (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+                             (static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+        }
+
+      compress(state, words);
+
+      bool isStored = false;
+      for(size_t lane = 0; lane < laneCount; lane++)
+        {
+          if(block + 1 != messages[lane].m_blockCount)
+            continue;
+
+          if(!isStored)
+            {
+              for(int i = 0; i < 8; i++)
+                Lanes::store(laneState[i], state[i]);
+              isStored = true;
+            }
+
+          uint8_t* digest = messages[lane].m_digest;
+          for(int i = 0; i < 8; i++, digest += 4)
+            {
+              uint32_t word = laneState[i][lane];
+              digest[0] = static_cast<uint8_t>(word >> 24);
+              digest[1] = static_cast<uint8_t>(word >> 16);
+              digest[2] = static_cast<uint8_t>(word >> 8);
+              digest[3] = static_cast<uint8_t>(word);
+            }
+        }
+    }
+}
+
+// orders the buffers by number of blocks, so that the lanes of a pass end together
+struct Sha256BlockCountLess
+{
+  explicit
+  Sha256BlockCountLess(const size_t* sizes)
+    : m_sizes(sizes)
+  {}
+
+  bool
+  operator()(size_t x, size_t y) const
+  { return (m_sizes[x] + 8) / 64 < (m_sizes[y] + 8) / 64; }
+
+  const size_t* m_sizes;
+};
+
+#endif
+
+// SHA-NI makes the single-buffer code of the crypto library faster than 8 lanes of AVX2
+// (it is used by the library versions built with it)
+static MultiBufferSha256::Kernel
+detectKernel()
+{
+#if defined(NDN_SHA256_HAS_AVX2_KERNEL)
+  unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+  bool hasSha = (__get_cpuid_max(0, 0) >= 7);
+  if(hasSha)
+    {
+      __cpuid_count(7, 0, eax, ebx, ecx, edx);
+      hasSha = (0 != (ebx & (1u << 29)));
+    }
+
+  // also checks that the operating system saves the AVX registers
+  if(!hasSha && __builtin_cpu_supports("avx2"))
+    return MultiBufferSha256::KERNEL_AVX2;
+#endif
+  return MultiBufferSha256::KERNEL_SERIAL;
+}
+
+MultiBufferSha256::Kernel
+MultiBufferSha256::getKernel()
+{
+  static const Kernel kernel = detectKernel();
+  return kernel;
+}
+
+bool
+MultiBufferSha256::hasKernel(Kernel kernel)
+{
+  switch(kernel){
+  case KERNEL_SERIAL:
+    return true;
+  case KERNEL_AVX2:
+#if defined(NDN_SHA256_HAS_AVX2_KERNEL)
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+  default:
+    return false;
+  }
+}
+
+void
+MultiBufferSha256::digest(const uint8_t* const* buffers, const size_t* sizes, size_t count, uint8_t* digests)
+{ digest(buffers, sizes, count, digests, getKernel()); }
+
+void
+MultiBufferSha256::digest(const uint8_t* const* buffers, const size_t* sizes, size_t count, uint8_t* digests,
+                          Kernel kernel)
+{
+  size_t done = 0;
+
+#if defined(NDN_SHA256_HAS_AVX2_KERNEL)
+  if(KERNEL_AVX2 == kernel && count > 1 && hasKernel(KERNEL_AVX2))
+    {
+      vector<size_t> order(count);
+      for(size_t i = 0; i < count; i++)
+        order[i] = i;
+      stable_sort(order.begin(), order.end(), Sha256BlockCountLess(sizes));
+
+      Sha256Message messages[Lanes::COUNT];
+      // a buffer left alone is not worth a pass
+      for(; count - done > 1; done += min(count - done, Lanes::COUNT))
+        {
+          size_t laneCount = min(count - done, Lanes::COUNT);
+          for(size_t lane = 0; lane < laneCount; lane++)
+            {
+              size_t i = order[done + lane];
+              messages[lane].reset(buffers[i], sizes[i], digests + i * DIGEST_SIZE);
+            }
+          digestLanes(messages, laneCount);
+        }
+
+      if(done < count)
+        {
+          size_t i = order[done];
+          CryptoPP::SHA256().CalculateDigest(digests + i * DIGEST_SIZE, buffers[i], sizes[i]);
+        }
+      return;
+    }
+#endif
+
+  CryptoPP::SHA256 hash;
+  for(; done < count; done++)
+    hash.CalculateDigest(digests + done * DIGEST_SIZE, buffers[done], sizes[done]);
+}
+
+size_t
+MultiBufferSha256::getLaneCount()
+{
+#if defined(NDN_SHA256_HAS_AVX2_KERNEL)
+  if(KERNEL_AVX2 == getKernel())
+    return Lanes::COUNT;
+#endif
+  return 1;
+}
+
+}//ndn
@@ -0,0 +1,75 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_MULTI_BUFFER_SHA256_HPP
+#define NDN_MULTI_BUFFER_SHA256_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace ndn
+{
+
+/**
+ * @brief SHA-256 of several independent buffers at once.
+ *
+ * Each 32-bit lane of an AVX2 register carries the state of one buffer, so a pass of the
+ * compression function hashes a block of 8 buffers.  Buffers are grouped by number of
+ * blocks so that the lanes of a pass finish together.  The kernel is chosen at run time:
+ * AVX2 on an x86 CPU that has it but not SHA-NI, otherwise, or for a buffer left alone,
+ * the digest is computed by CryptoPP one buffer after the other.
+ */
+class MultiBufferSha256
+{
+public:
+  static const size_t DIGEST_SIZE = 32;
+
+  enum Kernel {
+    KERNEL_SERIAL,
+    KERNEL_AVX2
+  };
+
+  /**
+   * @brief compute the digest of every buffer with the kernel chosen for the CPU
+   * @param buffers The buffers
+   * @param sizes The size of every buffer
+   * @param count The number of buffers
+   * @param digests Set to the digests, DIGEST_SIZE bytes per buffer in the order of buffers
+   */
+  static void
+  digest(const uint8_t* const* buffers, const size_t* sizes, size_t count, uint8_t* digests);
+
+  /**
+   * @brief compute the digest of every buffer with a kernel, KERNEL_SERIAL if the CPU does
+   *        not have it
+   */
+  static void
+  digest(const uint8_t* const* buffers, const size_t* sizes, size_t count, uint8_t* digests,
+         Kernel kernel);
+
+  /**
+   * @brief get the kernel chosen for the CPU
+   */
+  static Kernel
+  getKernel();
+
+  /**
+   * @brief check if the CPU and the build have a kernel
+   */
+  static bool
+  hasKernel(Kernel kernel);
+
+  /**
+   * @brief get the number of buffers hashed by a pass of the chosen kernel, 1 if serial
+   */
+  static size_t
+  getLaneCount();
+};
+
+}//ndn
+
+#endif
@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#include "work-stealing-pool.hpp"
+
+#include <boost/thread/locks.hpp>
+#include <boost/thread/tss.hpp>
+
+#include "logging.h"
+
+INIT_LOGGER("WorkStealingPool")
+
+using namespace std;
+
+namespace ndn
+{
+
+struct WorkerIdentity
+{
+  const WorkStealingPool* m_pool;
+  size_t m_index;
+};
+
+// the pool and the queue of the calling thread, if it is a worker
+static boost::thread_specific_ptr<WorkerIdentity> s_worker;
+
+// the shared counts and m_isRunning are only accessed through these, sequentially
+// consistent like the __sync updates
+template<typename T>
+static T
+atomicLoad(const T& value)
+{ return __atomic_load_n(&value, __ATOMIC_SEQ_CST); }
+
+template<typename T>
+static void
+atomicStore(T& value, T newValue)
+{ __atomic_store_n(&value, newValue, __ATOMIC_SEQ_CST); }
+
+WorkStealingPool::WorkStealingPool(size_t threadCount)
+  : m_isRunning(true)
+  , m_queuedCount(0)
+  , m_submitCount(0)
+  , m_idleCount(0)
+  , m_nextQueue(0)
+  , m_stealCount(0)
+{
+  if(0 == threadCount)
+    threadCount = max<size_t>(boost::thread::hardware_concurrency(), 1);
+
+  for(size_t i = 0; i < threadCount; i++)
+    m_queues.push_back(ptr_lib::make_shared<TaskQueue>());
+
+  for(size_t i = 0; i < threadCount; i++)
+    m_threads.create_thread(func_lib::bind(&WorkStealingPool::run, this, i));
+}
+
+WorkStealingPool::~WorkStealingPool()
+{ shutdown(); }
+
+bool
+WorkStealingPool::submit(const Task& task)
+{
+  // a task run during shutdown may still queue more work, to the queue of its worker
+  if(0 != s_worker.get() && this == s_worker->m_pool)
+    {
+      TaskQueue& queue = *m_queues[s_worker->m_index];
+      {
+        boost::lock_guard<boost::mutex> lock(queue.m_mutex);
+        queue.m_tasks.push_back(task);
+        __sync_fetch_and_add(&m_queuedCount, 1);
+      }
+      wakeUpWorker();
+      return true;
+    }
+
+  // counted before m_isRunning is read, so that no worker stops until the task is queued
+  __sync_fetch_and_add(&m_submitCount, 1);
+  if(!atomicLoad(m_isRunning))
+    {
+      __sync_fetch_and_sub(&m_submitCount, 1);
+      _LOG_DEBUG("task submitted after shutdown is dropped");
+      return false;
+    }
+
+  TaskQueue& queue = *m_queues[__sync_fetch_and_add(&m_nextQueue, 1) % m_queues.size()];
+  {
+    boost::lock_guard<boost::mutex> lock(queue.m_mutex);
+    queue.m_tasks.push_back(task);
+    __sync_fetch_and_add(&m_queuedCount, 1);
+  }
+  __sync_fetch_and_sub(&m_submitCount, 1);
+
+  wakeUpWorker();
+  return true;
+}
+
+void
+WorkStealingPool::wakeUpWorker()
+{
+  // a worker going to sleep counts itself before it checks the counts, and sleeps with
+  // m_mutex held, so the notification is not lost
+  if(0 == atomicLoad(m_idleCount))
+    return;
+
+  boost::lock_guard<boost::mutex> lock(m_mutex);
+  m_wakeUp.notify_one();
+}
+
+void
+WorkStealingPool::shutdown()
+{
+  {
+    boost::lock_guard<boost::mutex> lock(m_mutex);
+    if(!atomicLoad(m_isRunning))
+      return;
+    atomicStore(m_isRunning, false);
+    m_wakeUp.notify_all();
+  }
+  m_threads.join_all();
+}
+
+uint64_t
+WorkStealingPool::getStealCount()
+{ return atomicLoad(m_stealCount); }
+
+bool
+WorkStealingPool::takeTask(size_t index, Task& task)
+{
+  {
+    TaskQueue& own = *m_queues[index];
+    boost::lock_guard<boost::mutex> lock(own.m_mutex);
+    if(!own.m_tasks.empty())
+      {
+        task = own.m_tasks.back();
+        own.m_tasks.pop_back();
+        __sync_fetch_and_sub(&m_queuedCount, 1);
+        return true;
+      }
+  }
+
+  for(size_t i = 1; i < m_queues.size(); i++)
+    {
+      TaskQueue& victim = *m_queues[(index + i) % m_queues.size()];
+      boost::lock_guard<boost::mutex> lock(victim.m_mutex);
+      if(victim.m_tasks.empty())
+        continue;
+
+      task = victim.m_tasks.front();
+      victim.m_tasks.pop_front();
+      __sync_fetch_and_sub(&m_queuedCount, 1);
+      __sync_fetch_and_add(&m_stealCount, 1);
+      return true;
+    }
+
+  return false;
+}
+
+bool
+WorkStealingPool::waitForTask()
+{
+  boost::unique_lock<boost::mutex> lock(m_mutex);
+  __sync_fetch_and_add(&m_idleCount, 1);
+  bool hasTask = true;
+  while(true)
+    {
+      // read in the opposite order of submit, which queues the task before it stops
+      // counting itself, after it has read m_isRunning
+      bool isRunning = atomicLoad(m_isRunning);
+      size_t submitCount = atomicLoad(m_submitCount);
+      if(0 != atomicLoad(m_queuedCount))
+        break;
+      if(!isRunning && 0 == submitCount)
+        {
+          hasTask = false;
+          break;
+        }
+      m_wakeUp.wait(lock);
+    }
+  __sync_fetch_and_sub(&m_idleCount, 1);
+  return hasTask;
+}
+
+void
+WorkStealingPool::run(size_t index)
+{
+  WorkerIdentity* identity = new WorkerIdentity;
+  identity->m_pool = this;
+  identity->m_index = index;
+  s_worker.reset(identity);
+
+  while(true)
+    {
+      // a task counted but taken by another worker first sends this one back to wait
+      Task task;
+      if(!takeTask(index, task))
+        {
+          if(!waitForTask())
+            return;
+          continue;
+        }
+
+      try{
+        task();
+      }catch(std::exception &e){
+        _LOG_DEBUG("WorkStealingPool task error: " << e.what());
+      }catch(...){
+        _LOG_DEBUG("WorkStealingPool task error");
+      }
+    }
+}
+
+}//ndn
@@ -0,0 +1,119 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+#ifndef NDN_WORK_STEALING_POOL_HPP
+#define NDN_WORK_STEALING_POOL_HPP
+
+#include <ndn-cpp-dev/common.hpp>
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <deque>
+#include <vector>
+
+namespace ndn
+{
+
+/**
+ * @brief A fixed set of worker threads, each with its own task queue.
+ *
+ * A task submitted from a worker goes to the queue of that worker, any other task to the
+ * queues in turn.  A worker runs the most recent task of its own queue, and when the queue
+ * is empty steals the oldest task of another worker, so that a burst submitted to one
+ * queue spreads over all the threads.
+ *
+ * The pool is not lock-free: each queue has its own mutex, taken to push, pop or steal a
+ * task.  The counts shared by the workers are updated atomically, and the mutex of the
+ * pool is only taken by a worker going to sleep and by a submit that wakes one up.
+ */
+class WorkStealingPool
+{
+public:
+  typedef func_lib::function<void()> Task;
+
+  /**
+   * @brief start the workers
+   * @param threadCount the number of workers, 0 for one per hardware thread
+   */
+  explicit
+  WorkStealingPool(size_t threadCount = 0);
+
+  /**
+   * @brief run the remaining tasks and stop the workers
+   */
+  ~WorkStealingPool();
+
+  /**
+   * @brief run a task on a worker; an exception thrown by the task is logged and dropped
+   * @returns false if the task is dropped because the pool is shut down
+   */
+  bool
+  submit(const Task& task);
+
+  /**
+   * @brief run the remaining tasks, including the tasks they submit, and stop the workers;
+   *        tasks submitted later from other threads are dropped
+   */
+  void
+  shutdown();
+
+  size_t
+  getThreadCount() const
+  { return m_queues.size(); }
+
+  /**
+   * @brief get the number of tasks run by another worker than the one they were queued to
+   */
+  uint64_t
+  getStealCount();
+
+private:
+  struct TaskQueue
+  {
+    boost::mutex m_mutex;
+    std::deque<Task> m_tasks;
+  };
+
+  void
+  run(size_t index);
+
+  bool
+  takeTask(size_t index, Task& task);
+
+  /**
+   * @brief wait until a task is queued
+   * @returns false if the pool is shut down and no task is left
+   */
+  bool
+  waitForTask();
+
+  void
+  wakeUpWorker();
+
+private:
+  std::vector<ptr_lib::shared_ptr<TaskQueue> > m_queues;
+  boost::thread_group m_threads;
+
+  // workers sleep on m_wakeUp, m_isRunning is written with m_mutex held and read atomically
+  boost::mutex m_mutex;
+  boost::condition_variable m_wakeUp;
+  bool m_isRunning;
+
+  // atomic counts, the tasks in the queues, the submits from other threads in progress
+  // and the workers going to sleep; only read and written with atomic operations
+  size_t m_queuedCount;
+  size_t m_submitCount;
+  size_t m_idleCount;
+  size_t m_nextQueue;
+  uint64_t m_stealCount;
+};
+
+}//ndn
+
+#endif
@@ -10,16 +10,41 @@
 #include <ndn-cpp-dev/face.hpp>
 #include <ndn-cpp-dev/security/key-chain.hpp>
 #include <ndn-cpp-dev/security/verifier.hpp>
+#include <ndn-cpp-dev/security/signature-sha256.hpp>
 
 #include "../ndn-cpp-et/policy/sec-policy-simple.hpp"
+#include "../ndn-cpp-et/security/multi-buffer-sha256.hpp"
 
 #include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <new>
+#include <stdlib.h>
+#include <boost/thread/thread.hpp>
 
 #include <cryptopp/base64.h>
+#include <cryptopp/sha.h>
 
 using namespace ndn;
 using namespace std;
 
+// counts the allocations of the whole test program, see RuleAllocations
+static size_t s_allocationCount = 0;
+
+void*
+operator new(size_t size) throw(std::bad_alloc)
+{
+  __sync_fetch_and_add(&s_allocationCount, 1);
+  void* p = malloc(0 == size ? 1 : size);
+  if(0 == p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void
+operator delete(void* p) throw()
+{ free(p); }
+
 BOOST_AUTO_TEST_SUITE(PolicyTest)
 
 void
@@ -84,6 +109,17 @@ getRoot(const string & TrustAnchor)
   // return ptr_lib::make_shared<IdentityCertificate>();
 }
 
+string
+decodeBase64(const string & encoded)
+{
+  string decoded;
+  CryptoPP::StringSource ss(reinterpret_cast<const unsigned char *>(encoded.c_str()), 
+                            encoded.size(), 
+                            true,
+                            new CryptoPP::Base64Decoder(new CryptoPP::StringSink(decoded)));
+  return decoded;
+}
+
 BOOST_AUTO_TEST_CASE(Simple)
 {
 
@@ -160,6 +196,1010 @@ iVUF1QIBEQAA");
   }
 }
 
+BOOST_AUTO_TEST_CASE(RegexDegreeLimit)
+{
+  SecPolicySimple policy;
+  ptr_lib::shared_ptr<SecRuleRelative> rule = ptr_lib::make_shared<SecRuleRelative>("^([^<KEY>]*)<KEY><dsk-.*><ID-CERT>",
+                                                                                    "^([^<KEY>]*)<KEY>(<>*)<ksk-.*><ID-CERT>$",
+                                                                                    "==", "\\1", "\\1\\2", true);
+  ptr_lib::shared_ptr<SecRuleRelative> exponential = ptr_lib::make_shared<SecRuleRelative>("^(<>*<a>*)*$",
+                                                                                           "^([^<KEY>]*)<KEY><ksk-.*><ID-CERT>$",
+                                                                                           ">", "\\1", "\\1", true);
+
+  // no limit by default
+  BOOST_CHECK_NO_THROW(policy.addVerificationPolicyRule(exponential));
+
+  policy.setRegexDegreeLimit(8);
+  BOOST_CHECK_NO_THROW(policy.addVerificationPolicyRule(rule));
+  BOOST_CHECK_THROW(policy.addVerificationPolicyRule(exponential), SecPolicySimple::Error);
+  BOOST_CHECK_THROW(policy.addVerificationExemption(ptr_lib::make_shared<Regex>("^(<a>*)*<b>$")), SecPolicySimple::Error);
+
+  policy.setRegexDegreeLimit(1);
+  BOOST_CHECK_THROW(policy.addVerificationPolicyRule(rule), SecPolicySimple::Error);
+}
+
+BOOST_AUTO_TEST_CASE(PacketContext)
+{
+  SecRuleRelative rule("^([^<KEY>]*)<KEY><dsk-.*><ID-CERT>",
+                       "^([^<KEY>]*)<KEY>(<>*)<ksk-.*><ID-CERT>$",
+                       "==", "\\1", "\\1\\2", true);
+
+  Data data(Name("/ndn/ucla/KEY/dsk-1/ID-CERT/%01"));
+  SignatureSha256WithRsa signature;
+  signature.setKeyLocator(KeyLocator(Name("/ndn/KEY/ucla/ksk-2/ID-CERT")));
+  data.setSignature(signature);
+
+  VerificationContext context(data);
+  BOOST_REQUIRE(context.hasSignerName());
+  BOOST_CHECK_EQUAL(context.getSignerName(), Name("/ndn/KEY/ucla/ksk-2/ID-CERT"));
+  BOOST_CHECK_EQUAL(context.getDataView().size(), data.getName().size());
+  BOOST_CHECK_EQUAL(rule.satisfy(context), true);
+  BOOST_CHECK_EQUAL(rule.satisfy(data), true);
+
+  // without a signer name no rule is satisfied, the data name is still matched
+  Data unsignedData(Name("/ndn/ucla/KEY/dsk-1/ID-CERT/%01"));
+  VerificationContext unsignedContext(unsignedData);
+  BOOST_CHECK_EQUAL(unsignedContext.hasSignerName(), false);
+  BOOST_CHECK_THROW(unsignedContext.getSignerName(), VerificationContext::Error);
+  BOOST_CHECK_EQUAL(rule.matchDataName(unsignedContext), true);
+  BOOST_CHECK_EQUAL(rule.satisfy(unsignedContext), false);
+}
+
+BOOST_AUTO_TEST_CASE(RuleAllocations)
+{
+  SecPolicySimple policy;
+  policy.addSigningPolicyRule(ptr_lib::make_shared<SecRuleRelative>("^(<>*)<>$",
+                                                                    "^([^<KEY>]*)<KEY><dsk-.*><ID-CERT>$",
+                                                                    ">", "\\1", "\\1", true));
+  Name dataName("/ndn/ucla/yingdi/app/data/%00%01");
+  Name certName("/ndn/ucla/yingdi/KEY/dsk-1/ID-CERT");
+  Name otherName("/ndn/mit/KEY/dsk-2/ID-CERT");
+
+  // the first checks size the match results, the memos and the expanded names
+  BOOST_REQUIRE_EQUAL(policy.checkSigningPolicy(dataName, certName), true);
+  BOOST_REQUIRE_EQUAL(policy.checkSigningPolicy(dataName, otherName), false);
+
+  size_t allocationCount = s_allocationCount;
+  int accepted = 0;
+  for(int i = 0; i < 100; i++)
+    {
+      accepted += (policy.checkSigningPolicy(dataName, certName) ? 1 : 0);
+      accepted += (policy.checkSigningPolicy(dataName, otherName) ? 1 : 0);
+    }
+  allocationCount = s_allocationCount - allocationCount;
+
+  BOOST_CHECK_EQUAL(accepted, 100);
+  BOOST_CHECK_EQUAL(allocationCount, 0);
+}
+
+BOOST_AUTO_TEST_CASE(RuleDecisions)
+{
+  RuleDecisionCache cache(2, 2);
+  bool isAccepted = false;
+  cache.insert(Name("/ndn/ucla/a/1"), Name("/ndn/KEY/ksk-1/ID-CERT"), true, cache.getGeneration());
+  // keyed by the first two components of the data name
+  BOOST_CHECK_EQUAL(cache.find(Name("/ndn/ucla/b"), Name("/ndn/KEY/ksk-1/ID-CERT"), isAccepted), true);
+  BOOST_CHECK_EQUAL(isAccepted, true);
+  BOOST_CHECK_EQUAL(cache.find(Name("/ndn/ucla/b"), Name("/ndn/KEY/ksk-2/ID-CERT"), isAccepted), false);
+
+  cache.insert(Name("/ndn/mit"), Name("/ndn/KEY/ksk-1/ID-CERT"), false, cache.getGeneration());
+  cache.insert(Name("/ndn/ucsd"), Name("/ndn/KEY/ksk-1/ID-CERT"), false, cache.getGeneration());
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+  BOOST_CHECK_EQUAL(cache.find(Name("/ndn/ucla"), Name("/ndn/KEY/ksk-1/ID-CERT"), isAccepted), false);
+  BOOST_CHECK_EQUAL(cache.find(Name("/ndn/mit"), Name("/ndn/KEY/ksk-1/ID-CERT"), isAccepted), true);
+  BOOST_CHECK_EQUAL(isAccepted, false);
+
+  // outcomes of older generations are neither returned nor stored
+  uint64_t generation = cache.getGeneration();
+  cache.invalidate();
+  BOOST_CHECK_EQUAL(cache.find(Name("/ndn/mit"), Name("/ndn/KEY/ksk-1/ID-CERT"), isAccepted), false);
+  cache.insert(Name("/ndn/mit"), Name("/ndn/KEY/ksk-1/ID-CERT"), true, generation);
+  BOOST_CHECK_EQUAL(cache.find(Name("/ndn/mit"), Name("/ndn/KEY/ksk-1/ID-CERT"), isAccepted), false);
+
+  // a verification rule added to the policy invalidates the cache
+  ptr_lib::shared_ptr<RuleDecisionCache> policyCache = ptr_lib::make_shared<RuleDecisionCache>();
+  SecPolicySimple policy;
+  policy.setRuleDecisionCache(policyCache);
+  generation = policyCache->getGeneration();
+  policy.addVerificationPolicyRule(ptr_lib::make_shared<SecRuleRelative>("^(<>*)$", "^([^<KEY>]*)<KEY><ksk-.*><ID-CERT>$",
+                                                                         ">", "\\1", "\\1", true));
+  BOOST_CHECK(policyCache->getGeneration() > generation);
+}
+
+BOOST_AUTO_TEST_CASE(VerificationResults)
+{
+  Data data(Name("/ndn/ucla/a/1"));
+  const uint8_t content[] = {1, 2, 3};
+  data.setContent(content, sizeof(content));
+  SignatureSha256WithRsa signature;
+  signature.setKeyLocator(KeyLocator(Name("/ndn/ucla/KEY/dsk-1/ID-CERT")));
+  const uint8_t value[] = {4, 5, 6, 7};
+  signature.setValue(Block(Tlv::SignatureValue, value, sizeof(value)));
+  data.setSignature(signature);
+
+  Data other(data);
+  other.setContent(content, 2);
+  VerificationResultCache::Digest digest = VerificationResultCache::computeDigest(data);
+  BOOST_CHECK_EQUAL(digest.size(), 32 + sizeof(value));
+  BOOST_CHECK(digest != VerificationResultCache::computeDigest(other));
+
+  // keyed by the digest of the signed portion, the one verified with the key
+  uint8_t signedDigest[CryptoPP::SHA256::DIGESTSIZE];
+  BOOST_REQUIRE(DecodedPublicKey::computeDigest(data.wireEncode(), signedDigest));
+  BOOST_CHECK(digest == VerificationResultCache::makeDigest(data.wireEncode(), signedDigest));
+  BOOST_CHECK_EQUAL(memcmp(digest.c_str(), signedDigest, sizeof(signedDigest)), 0);
+
+  IdentityCertificate certificate;
+  certificate.setName(Name("/ndn/ucla/KEY/dsk-1/ID-CERT/%01"));
+  certificate.setNotAfter(4102444800000ULL); // 2100-01-01
+
+  VerificationResultCache cache(10);
+  BOOST_CHECK_EQUAL(cache.find(digest, certificate.getName()), false);
+  cache.insert(digest, certificate);
+  BOOST_CHECK_EQUAL(cache.find(digest, certificate.getName()), true);
+  // another version of the certificate
+  BOOST_CHECK_EQUAL(cache.find(digest, Name("/ndn/ucla/KEY/dsk-1/ID-CERT/%02")), false);
+
+  // a certificate that has expired is not cached
+  IdentityCertificate expired(certificate);
+  expired.setName(Name("/ndn/ucla/KEY/dsk-1/ID-CERT/%00"));
+  expired.setNotAfter(1);
+  cache.insert(digest, expired);
+  BOOST_CHECK_EQUAL(cache.find(digest, expired.getName()), false);
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(DecodedKey)
+{
+  // 1024-bit RSA key, and the SHA256withRSA signature of "ndn/ucla/signed-portion"
+  string key = decodeBase64("MIGfMA0GCSqGSIb3DQEBAQUAA4GNADCBiQKBgQDCHF61w4STwMzA5DzMtDqHdD+BebAog71SCk0XUqeFbZuVNQrJ"
+                            "cmstHuU8lt+QN6QHtrYydyL78wFcG8hx7lSgez8aV1fK9SU+h0rfkZPeFSmQfR8LE29hsVTvYR4CBtlcnnGWxXUE"
+                            "W9jN+PXIvbxueLY2tcYrQaskSa3v6/ew6QIDAQAB");
+  string sig = decodeBase64("JFD4nyT6Vqb/ntIZ9WnRSM1XJe/Cr/tbYcYZLxQqAruTNDCnxb8/jXptey3Z00jK6pTpgYwL76QM72zJzAqGLZ3C"
+                            "pQNViTdYO567Qkb7LoIoMAbnTPVTZMdkAvrtMWP9NZveeKOUmAKKBEKWFpPdvL2oKoytPCFhaOLDmZvQ6Mk=");
+  string message = "ndn/ucla/signed-portion";
+
+  DecodedPublicKey decodedKey(PublicKey(reinterpret_cast<const uint8_t*>(key.c_str()), key.size()));
+  BOOST_CHECK_EQUAL(decodedKey.getModulusSize(), 128);
+  BOOST_CHECK_EQUAL(decodedKey.verifySignature(reinterpret_cast<const uint8_t*>(message.c_str()), message.size(),
+                                               reinterpret_cast<const uint8_t*>(sig.c_str()), sig.size()), true);
+
+  message[0] = 'N';
+  BOOST_CHECK_EQUAL(decodedKey.verifySignature(reinterpret_cast<const uint8_t*>(message.c_str()), message.size(),
+                                               reinterpret_cast<const uint8_t*>(sig.c_str()), sig.size()), false);
+  message[0] = 'n';
+  BOOST_CHECK_EQUAL(decodedKey.verifySignature(reinterpret_cast<const uint8_t*>(message.c_str()), message.size(),
+                                               reinterpret_cast<const uint8_t*>(sig.c_str()), sig.size() - 1), false);
+
+  // the digest can be computed ahead of the exponentiation
+  uint8_t digest[CryptoPP::SHA256::DIGESTSIZE];
+  CryptoPP::SHA256().CalculateDigest(digest, reinterpret_cast<const uint8_t*>(message.c_str()), message.size());
+  BOOST_CHECK_EQUAL(decodedKey.verifyDigest(digest, reinterpret_cast<const uint8_t*>(sig.c_str()), sig.size()), true);
+  digest[0] ^= 1;
+  BOOST_CHECK_EQUAL(decodedKey.verifyDigest(digest, reinterpret_cast<const uint8_t*>(sig.c_str()), sig.size()), false);
+
+  BOOST_CHECK_THROW(DecodedPublicKey(PublicKey(reinterpret_cast<const uint8_t*>(sig.c_str()), sig.size())),
+                    DecodedPublicKey::Error);
+
+  // the key type is checked before decoding, an EC key is not decoded
+  PublicKey rsaKey(reinterpret_cast<const uint8_t*>(key.c_str()), key.size());
+  BOOST_CHECK(DecodedPublicKey::isRsaKey(rsaKey));
+  BOOST_REQUIRE(static_cast<bool>(DecodedPublicKey::decode(rsaKey)));
+  BOOST_CHECK(DecodedPublicKey::decode(rsaKey)->canVerify(Signature::Sha256WithRsa));
+  BOOST_CHECK(!DecodedPublicKey::decode(rsaKey)->canVerify(Signature::Sha256));
+
+  // the header of a P-256 SubjectPublicKeyInfo, up to the point
+  const uint8_t ecKey[] = {0x30, 0x59, 0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01,
+                           0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04};
+  BOOST_CHECK(!DecodedPublicKey::isRsaKey(PublicKey(ecKey, sizeof(ecKey))));
+  BOOST_CHECK(!static_cast<bool>(DecodedPublicKey::decode(PublicKey(ecKey, sizeof(ecKey)))));
+  BOOST_CHECK(!static_cast<bool>(DecodedPublicKey::decode(PublicKey(reinterpret_cast<const uint8_t*>(sig.c_str()),
+                                                                              sig.size()))));
+}
+
+BOOST_AUTO_TEST_CASE(MultiBufferDigest)
+{
+  // every length of padding, in batches that fill the lanes, leave a lane alone, or have one buffer
+  vector<uint8_t> bytes(300);
+  for(size_t i = 0; i < bytes.size(); i++)
+    bytes[i] = static_cast<uint8_t>(i * 7 + 1);
+
+  // every kernel the CPU has, whichever is chosen for it
+  BOOST_CHECK(MultiBufferSha256::hasKernel(MultiBufferSha256::getKernel()));
+  const MultiBufferSha256::Kernel kernels[] = {MultiBufferSha256::KERNEL_SERIAL, MultiBufferSha256::KERNEL_AVX2};
+  for(size_t k = 0; k < sizeof(kernels) / sizeof(kernels[0]); k++)
+    {
+      if(!MultiBufferSha256::hasKernel(kernels[k]))
+        continue;
+
+      for(size_t count = 1; count <= 2 * 8 + 1; count++)
+        {
+          vector<const uint8_t*> buffers;
+          vector<size_t> sizes;
+          for(size_t i = 0; i < count; i++)
+            {
+              buffers.push_back(&bytes[i]);
+              sizes.push_back((i * 37 + count * 11) % (bytes.size() - count));
+            }
+
+          vector<uint8_t> digests(count * MultiBufferSha256::DIGEST_SIZE);
+          MultiBufferSha256::digest(&buffers[0], &sizes[0], count, &digests[0], kernels[k]);
+          for(size_t i = 0; i < count; i++)
+            {
+              uint8_t expected[CryptoPP::SHA256::DIGESTSIZE];
+              CryptoPP::SHA256().CalculateDigest(expected, buffers[i], sizes[i]);
+              BOOST_CHECK(0 == memcmp(&digests[i * MultiBufferSha256::DIGEST_SIZE], expected, sizeof(expected)));
+            }
+        }
+    }
+}
+
+void
+countTask(boost::mutex* mutex, int* count)
+{
+  boost::lock_guard<boost::mutex> lock(*mutex);
+  (*count)++;
+}
+
+void
+submitTasks(WorkStealingPool* pool, boost::mutex* mutex, int* count, int taskCount)
+{
+  for(int i = 0; i < taskCount; i++)
+    pool->submit(bind(&countTask, mutex, count));
+}
+
+BOOST_AUTO_TEST_CASE(VerificationPool)
+{
+  boost::mutex mutex;
+  int count = 0;
+  {
+    WorkStealingPool pool(4);
+    BOOST_CHECK_EQUAL(pool.getThreadCount(), 4);
+    // a task submitted by a worker is queued to that worker, the others steal it
+    pool.submit(bind(&submitTasks, &pool, &mutex, &count, 1000));
+    submitTasks(&pool, &mutex, &count, 100);
+    pool.shutdown();
+    BOOST_CHECK(!pool.submit(bind(&countTask, &mutex, &count)));
+  }
+  BOOST_CHECK_EQUAL(count, 1100);
+}
+
+ptr_lib::shared_ptr<Data>
+makeSignedData(const string& name, const string& keyLocatorName)
+{
+  ptr_lib::shared_ptr<Data> data = ptr_lib::make_shared<Data>(Name(name));
+  SignatureSha256WithRsa signature;
+  signature.setKeyLocator(KeyLocator(Name(keyLocatorName)));
+  const uint8_t value[] = {1, 2, 3, 4};
+  signature.setValue(Block(Tlv::SignatureValue, value, sizeof(value)));
+  data->setSignature(signature);
+  return data;
+}
+
+void
+countCallback(const ptr_lib::shared_ptr<Data>& data, boost::thread::id* thread, int* count)
+{
+  *thread = boost::this_thread::get_id();
+  (*count)++;
+}
+
+void
+collectData(const ptr_lib::shared_ptr<Data>& data, vector<Name>* names)
+{ names->push_back(data->getName()); }
+
+// a policy accepting the packets signed by a dsk of their prefix, and the names of the
+// packets it has verified and failed
+struct DskPolicyFixture
+{
+  DskPolicyFixture()
+    : onVerified(bind(&collectData, _1, &verified))
+    , onVerifyFailed(bind(&collectData, _1, &failed))
+  {
+    policy.addVerificationPolicyRule(ptr_lib::make_shared<SecRuleRelative>("^(<>*)<>$", "^([^<KEY>]*)<KEY><dsk-.*><ID-CERT>$",
+                                                                           ">", "\\1", "\\1", true));
+  }
+
+  SecPolicySimple policy;
+  vector<Name> verified;
+  vector<Name> failed;
+  OnVerified onVerified;
+  OnVerifyFailed onVerifyFailed;
+};
+
+BOOST_FIXTURE_TEST_CASE(AsyncVerification, DskPolicyFixture)
+{
+  ptr_lib::shared_ptr<IdentityCertificate> anchor = ptr_lib::make_shared<IdentityCertificate>();
+  anchor->setName(Name("/ndn/ucla/KEY/dsk-1/ID-CERT/%01"));
+
+  ptr_lib::shared_ptr<Data> data = makeSignedData("/ndn/ucla/a/1", "/ndn/ucla/KEY/dsk-1/ID-CERT");
+
+  ptr_lib::shared_ptr<boost::asio::io_service> ioService = ptr_lib::make_shared<boost::asio::io_service>();
+  ptr_lib::shared_ptr<WorkStealingPool> pool = ptr_lib::make_shared<WorkStealingPool>(2);
+
+  BOOST_CHECK_THROW(policy.setVerificationPool(pool, ptr_lib::shared_ptr<boost::asio::io_service>()),
+                    SecPolicySimple::Error);
+  policy.setVerificationPool(pool, ioService);
+  policy.addTrustAnchor(anchor);
+
+  boost::thread::id verifiedThread;
+  boost::thread::id failedThread;
+  int verifiedCount = 0;
+  int failedCount = 0;
+  BOOST_CHECK(!static_cast<bool>(policy.checkVerificationPolicy(data, 0,
+                                                               bind(&countCallback, _1, &verifiedThread, &verifiedCount),
+                                                               bind(&countCallback, _1, &failedThread, &failedCount))));
+
+  // the signature does not match the key, the failure is delivered on the io_service
+  boost::asio::io_service::work work(*ioService);
+  ioService->run_one();
+  pool->shutdown();
+  ioService->poll();
+  BOOST_CHECK_EQUAL(verifiedCount, 0);
+  BOOST_CHECK_EQUAL(failedCount, 1);
+  BOOST_CHECK(failedThread == boost::this_thread::get_id());
+}
+
+void
+waitForGate(boost::mutex* gate)
+{ boost::lock_guard<boost::mutex> lock(*gate); }
+
+void
+destroyPolicy(ptr_lib::shared_ptr<SecPolicySimple>* policy)
+{ policy->reset(); }
+
+BOOST_AUTO_TEST_CASE(PoolOutlivesPolicy)
+{
+  ptr_lib::shared_ptr<IdentityCertificate> anchor = ptr_lib::make_shared<IdentityCertificate>();
+  anchor->setName(Name("/ndn/ucla/KEY/dsk-1/ID-CERT/%01"));
+
+  ptr_lib::shared_ptr<boost::asio::io_service> ioService = ptr_lib::make_shared<boost::asio::io_service>();
+  ptr_lib::shared_ptr<WorkStealingPool> pool = ptr_lib::make_shared<WorkStealingPool>(1);
+
+  // the only worker is held until the policy is being destroyed
+  boost::mutex gate;
+  boost::unique_lock<boost::mutex> gateLock(gate);
+  pool->submit(bind(&waitForGate, &gate));
+
+  ptr_lib::shared_ptr<SecPolicySimple> policy = ptr_lib::make_shared<SecPolicySimple>();
+  policy->setVerificationPool(pool, ioService);
+  policy->addVerificationPolicyRule(ptr_lib::make_shared<SecRuleRelative>("^(<>*)<>$", "^([^<KEY>]*)<KEY><dsk-.*><ID-CERT>$",
+                                                                          ">", "\\1", "\\1", true));
+  policy->addTrustAnchor(anchor);
+
+  boost::thread::id verifiedThread;
+  boost::thread::id failedThread;
+  int verifiedCount = 0;
+  int failedCount = 0;
+  policy->checkVerificationPolicy(makeSignedData("/ndn/ucla/a/1", "/ndn/ucla/KEY/dsk-1/ID-CERT"), 0,
+                                  bind(&countCallback, _1, &verifiedThread, &verifiedCount),
+                                  bind(&countCallback, _1, &failedThread, &failedCount));
+
+  // the destructor returns once the queued verification has used the policy
+  boost::thread destroyer(bind(&destroyPolicy, &policy));
+  gateLock.unlock();
+  destroyer.join();
+  BOOST_CHECK(!static_cast<bool>(policy));
+
+  ioService->poll();
+  BOOST_CHECK_EQUAL(verifiedCount, 0);
+  BOOST_CHECK_EQUAL(failedCount, 1);
+  pool->shutdown();
+
+  // a pool shut down leaves the verification to the calling thread
+  policy = ptr_lib::make_shared<SecPolicySimple>();
+  policy->setVerificationPool(pool, ioService);
+  policy->addVerificationPolicyRule(ptr_lib::make_shared<SecRuleRelative>("^(<>*)<>$", "^([^<KEY>]*)<KEY><dsk-.*><ID-CERT>$",
+                                                                          ">", "\\1", "\\1", true));
+  policy->addTrustAnchor(anchor);
+  policy->checkVerificationPolicy(makeSignedData("/ndn/ucla/a/2", "/ndn/ucla/KEY/dsk-1/ID-CERT"), 0,
+                                  bind(&countCallback, _1, &verifiedThread, &verifiedCount),
+                                  bind(&countCallback, _1, &failedThread, &failedCount));
+  policy.reset();
+  ioService->reset();
+  ioService->poll();
+  BOOST_CHECK_EQUAL(failedCount, 2);
+}
+
+ptr_lib::shared_ptr<Data>
+makeDigestData(const string& name)
+{
+  ptr_lib::shared_ptr<Data> data = ptr_lib::make_shared<Data>(Name(name));
+  data->setSignature(SignatureSha256());
+  uint8_t digest[CryptoPP::SHA256::DIGESTSIZE] = {0};
+  data->setSignatureValue(Block(Tlv::SignatureValue, digest, sizeof(digest)));
+
+  // the signed portion does not depend on the signature value
+  BOOST_REQUIRE(DecodedPublicKey::computeDigest(data->wireEncode(), digest));
+  data->setSignatureValue(Block(Tlv::SignatureValue, digest, sizeof(digest)));
+  return data;
+}
+
+BOOST_FIXTURE_TEST_CASE(SignatureTypes, DskPolicyFixture)
+{
+  policy.addDigestExemption(ptr_lib::make_shared<Regex>("^<ndn><internal><>*$"));
+
+  BOOST_CHECK(policy.requireVerify(*makeDigestData("/ndn/internal/a")));
+  BOOST_CHECK(!policy.skipVerifyAndTrust(*makeDigestData("/ndn/internal/a")));
+
+  // DigestSha256 needs no certificate under a digest exemption, and is checked
+  BOOST_CHECK(!static_cast<bool>(policy.checkVerificationPolicy(makeDigestData("/ndn/internal/a"), 0,
+                                                                onVerified, onVerifyFailed)));
+  BOOST_REQUIRE_EQUAL(verified.size(), 1);
+  BOOST_CHECK_EQUAL(verified[0], Name("/ndn/internal/a"));
+
+  ptr_lib::shared_ptr<Data> tampered = makeDigestData("/ndn/internal/b");
+  const uint8_t content[] = {1};
+  tampered->setContent(content, sizeof(content));
+  policy.checkVerificationPolicy(tampered, 0, onVerified, onVerifyFailed);
+  // not exempted
+  policy.checkVerificationPolicy(makeDigestData("/ndn/ucla/a"), 0, onVerified, onVerifyFailed);
+  // a type that is not supported fails without exception
+  ptr_lib::shared_ptr<Data> unsupported = makeDigestData("/ndn/internal/c");
+  const uint8_t info[] = {Tlv::SignatureInfo, 3, Tlv::SignatureType, 1, 3};
+  unsupported->setSignature(Signature(Block(info, sizeof(info)), unsupported->getSignature().getValue()));
+  policy.checkVerificationPolicy(unsupported, 0, onVerified, onVerifyFailed);
+  BOOST_CHECK_EQUAL(verified.size(), 1);
+  BOOST_CHECK_EQUAL(failed.size(), 3);
+
+  // a batch dispatches every packet on its type
+  vector<ptr_lib::shared_ptr<Data> > dataList;
+  dataList.push_back(makeDigestData("/ndn/internal/d"));
+  dataList.push_back(makeDigestData("/ndn/ucla/d"));
+  dataList.push_back(makeSignedData("/ndn/mit/d", "/ndn/ucla/KEY/dsk-1/ID-CERT"));
+  BOOST_CHECK(policy.verifyBatch(dataList, onVerified, onVerifyFailed).empty());
+  BOOST_CHECK_EQUAL(verified.size(), 2);
+  BOOST_CHECK_EQUAL(verified[1], Name("/ndn/internal/d"));
+  BOOST_CHECK_EQUAL(failed.size(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(SignedWire)
+{
+  ptr_lib::shared_ptr<Data> sent = makeSignedData("/ndn/ucla/a/%00", "/ndn/ucla/KEY/dsk-1/ID-CERT");
+  const uint8_t content[] = {5, 6, 7};
+  sent->setContent(content, sizeof(content));
+  Block wire(sent->wireEncode().wire(), sent->wireEncode().size());
+
+  Data received;
+  received.wireDecode(wire);
+
+  // the signed portion and the signature bits are read in place in the received buffer
+  const uint8_t* buf = 0;
+  size_t size = 0;
+  const uint8_t* sig = 0;
+  size_t sigSize = 0;
+  BOOST_REQUIRE(DecodedPublicKey::parseSignedWire(received.wireEncode(), buf, size, sig, sigSize));
+  BOOST_CHECK(buf == wire.value());
+  BOOST_CHECK_EQUAL(size, wire.value_size() - received.getSignature().getValue().size());
+  BOOST_CHECK(sig >= wire.wire() && sig + sigSize == wire.wire() + wire.size());
+  BOOST_CHECK_EQUAL(sigSize, 4);
+  BOOST_CHECK_EQUAL(sig[0], 1);
+
+  // the wire is unchanged when the packet is changed and encoded again
+  received.setContent(content, 1);
+  BOOST_CHECK(received.wireEncode().size() != wire.size());
+  BOOST_REQUIRE(DecodedPublicKey::parseSignedWire(wire, buf, size, sig, sigSize));
+  BOOST_CHECK(buf == wire.value());
+
+  // without SignatureValue, or with a truncated element
+  const uint8_t withoutSignature[] = {Tlv::Data, 3, Tlv::Name, 1, 0};
+  BOOST_CHECK(!DecodedPublicKey::parseSignedWire(Block(withoutSignature, 5), buf, size, sig, sigSize));
+  const uint8_t truncated[] = {Tlv::Data, 4, Tlv::Name, 0, Tlv::SignatureValue, 5};
+  BOOST_CHECK(!DecodedPublicKey::parseSignedWire(Block(truncated, 6), buf, size, sig, sigSize));
+  BOOST_CHECK(!DecodedPublicKey::parseSignedWire(Block(), buf, size, sig, sigSize));
+}
+
+BOOST_FIXTURE_TEST_CASE(SpeculativeDigest, DskPolicyFixture)
+{
+  ptr_lib::shared_ptr<Data> data = makeSignedData("/ndn/ucla/a/%00", "/ndn/ucla/KEY/dsk-1/ID-CERT");
+
+  // the signed portion ends where the SignatureValue TLV starts
+  const Block& wire = data->wireEncode();
+  const Block& signatureValue = data->getSignature().getValue();
+  uint8_t expected[CryptoPP::SHA256::DIGESTSIZE];
+  CryptoPP::SHA256().CalculateDigest(expected, wire.value(), wire.value_size() - signatureValue.size());
+  uint8_t digest[CryptoPP::SHA256::DIGESTSIZE];
+  BOOST_CHECK(DecodedPublicKey::computeDigest(wire, digest));
+  BOOST_CHECK(0 == memcmp(digest, expected, sizeof(digest)));
+
+  // a packet waiting for its certificate is hashed on the pool, its callback is still delivered once
+  ptr_lib::shared_ptr<boost::asio::io_service> ioService = ptr_lib::make_shared<boost::asio::io_service>();
+  ptr_lib::shared_ptr<WorkStealingPool> pool = ptr_lib::make_shared<WorkStealingPool>(2);
+
+  policy.setVerificationPool(pool, ioService);
+  ptr_lib::shared_ptr<ValidationRequest> request = policy.checkVerificationPolicy(data, 0, onVerified, onVerifyFailed);
+  BOOST_REQUIRE(static_cast<bool>(request));
+
+  request->m_onVerifyFailed(ptr_lib::make_shared<Data>(Name("/ndn/ucla/KEY/dsk-1/ID-CERT/%01")));
+  pool->shutdown();
+  ioService->poll();
+  BOOST_CHECK(verified.empty());
+  BOOST_CHECK_EQUAL(failed.size(), 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(BatchVerification, DskPolicyFixture)
+{
+  ptr_lib::shared_ptr<IdentityCertificate> anchor = ptr_lib::make_shared<IdentityCertificate>();
+  anchor->setName(Name("/ndn/ucla/KEY/dsk-1/ID-CERT/%01"));
+
+  policy.addTrustAnchor(anchor);
+
+  vector<ptr_lib::shared_ptr<Data> > dataList;
+  // signed by the trust anchor, with signatures that do not match its key
+  dataList.push_back(makeSignedData("/ndn/ucla/a/%00", "/ndn/ucla/KEY/dsk-1/ID-CERT"));
+  dataList.push_back(makeSignedData("/ndn/ucla/a/%01", "/ndn/ucla/KEY/dsk-1/ID-CERT"));
+  // signed by a key that must be fetched
+  dataList.push_back(makeSignedData("/ndn/ucla/b/%00", "/ndn/ucla/KEY/dsk-2/ID-CERT"));
+  dataList.push_back(makeSignedData("/ndn/ucla/b/%01", "/ndn/ucla/KEY/dsk-2/ID-CERT"));
+  // rejected by the rule
+  dataList.push_back(makeSignedData("/ndn/mit/b/%00", "/ndn/ucla/KEY/dsk-2/ID-CERT"));
+  // without signer name
+  dataList.push_back(ptr_lib::make_shared<Data>(Name("/ndn/ucla/c/%00")));
+
+  vector<ptr_lib::shared_ptr<ValidationRequest> > requests = policy.verifyBatch(dataList, onVerified, onVerifyFailed);
+  BOOST_CHECK_EQUAL(verified.size(), 0);
+  BOOST_CHECK_EQUAL(failed.size(), 4);
+  BOOST_CHECK(failed.end() != find(failed.begin(), failed.end(), Name("/ndn/mit/b/%00")));
+  BOOST_CHECK(failed.end() == find(failed.begin(), failed.end(), Name("/ndn/ucla/b/%00")));
+
+  // one request for the group of /ndn/ucla/KEY/dsk-2/ID-CERT, covering both of its accepted packets
+  BOOST_REQUIRE_EQUAL(requests.size(), 1);
+  BOOST_CHECK_EQUAL(requests[0]->m_interest->getName(), Name("/ndn/ucla/KEY/dsk-2/ID-CERT"));
+  BOOST_CHECK_EQUAL(requests[0]->m_stepCount, 1);
+  requests[0]->m_onVerifyFailed(ptr_lib::make_shared<Data>(Name("/ndn/ucla/KEY/dsk-2/ID-CERT/%01")));
+  BOOST_CHECK_EQUAL(failed.size(), 6);
+  BOOST_CHECK(failed.end() != find(failed.begin(), failed.end(), Name("/ndn/ucla/b/%01")));
+}
+
+BOOST_FIXTURE_TEST_CASE(CoalescedFetches, DskPolicyFixture)
+{
+  // only the first packet of an unknown key fetches its certificate
+  ptr_lib::shared_ptr<ValidationRequest> request =
+    policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%00", "/ndn/ucla/KEY/dsk-1/ID-CERT"), 0, onVerified, onVerifyFailed);
+  BOOST_REQUIRE(static_cast<bool>(request));
+  BOOST_CHECK_EQUAL(request->m_interest->getName(), Name("/ndn/ucla/KEY/dsk-1/ID-CERT"));
+  BOOST_CHECK(!static_cast<bool>(policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%01", "/ndn/ucla/KEY/dsk-1/ID-CERT"),
+                                                                0, onVerified, onVerifyFailed)));
+
+  vector<ptr_lib::shared_ptr<Data> > dataList;
+  dataList.push_back(makeSignedData("/ndn/ucla/a/%02", "/ndn/ucla/KEY/dsk-1/ID-CERT"));
+  dataList.push_back(makeSignedData("/ndn/ucla/b/%00", "/ndn/ucla/KEY/dsk-2/ID-CERT"));
+  vector<ptr_lib::shared_ptr<ValidationRequest> > requests = policy.verifyBatch(dataList, onVerified, onVerifyFailed);
+  BOOST_REQUIRE_EQUAL(requests.size(), 1);
+  BOOST_CHECK_EQUAL(requests[0]->m_interest->getName(), Name("/ndn/ucla/KEY/dsk-2/ID-CERT"));
+  BOOST_CHECK(failed.empty());
+
+  // every waiter of the fetch fails with it, once
+  request->m_onVerifyFailed(ptr_lib::make_shared<Data>(Name("/ndn/ucla/KEY/dsk-1/ID-CERT/%01")));
+  BOOST_CHECK_EQUAL(failed.size(), 3);
+  request->m_onVerifyFailed(ptr_lib::make_shared<Data>(Name("/ndn/ucla/KEY/dsk-1/ID-CERT/%01")));
+  BOOST_CHECK_EQUAL(failed.size(), 3);
+  BOOST_CHECK(verified.empty());
+
+  // the next packet fetches the certificate again
+  BOOST_CHECK(static_cast<bool>(policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%03", "/ndn/ucla/KEY/dsk-1/ID-CERT"),
+                                                               0, onVerified, onVerifyFailed)));
+}
+
+BOOST_FIXTURE_TEST_CASE(FetchDeadlines, DskPolicyFixture)
+{
+  ptr_lib::shared_ptr<boost::asio::io_service> ioService = ptr_lib::make_shared<boost::asio::io_service>();
+  policy.setFetchDeadline(ioService, 10);
+
+  ptr_lib::shared_ptr<Data> first = makeSignedData("/ndn/ucla/a/%00", "/ndn/ucla/KEY/dsk-1/ID-CERT");
+  ptr_lib::shared_ptr<ValidationRequest> request = policy.checkVerificationPolicy(first, 0, onVerified, onVerifyFailed);
+  BOOST_REQUIRE(static_cast<bool>(request));
+  BOOST_CHECK(!static_cast<bool>(policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%01", "/ndn/ucla/KEY/dsk-1/ID-CERT"),
+                                                                0, onVerified, onVerifyFailed)));
+
+  // the Interest times out and the Verifier fails the packet that issued it, the packet that
+  // joined the fetch fails at the deadline
+  onVerifyFailed(first);
+  ioService->run();
+  BOOST_REQUIRE_EQUAL(failed.size(), 2);
+  BOOST_CHECK_EQUAL(failed[1], Name("/ndn/ucla/a/%01"));
+
+  // the next packet fetches the certificate again, a fetch done before its deadline fails
+  // its packets once
+  request = policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%02", "/ndn/ucla/KEY/dsk-1/ID-CERT"),
+                                           0, onVerified, onVerifyFailed);
+  BOOST_REQUIRE(static_cast<bool>(request));
+  BOOST_CHECK(!static_cast<bool>(policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%03", "/ndn/ucla/KEY/dsk-1/ID-CERT"),
+                                                                0, onVerified, onVerifyFailed)));
+  request->m_onVerifyFailed(ptr_lib::make_shared<Data>(Name("/ndn/ucla/KEY/dsk-1/ID-CERT/%01")));
+  BOOST_CHECK_EQUAL(failed.size(), 4);
+  ioService->reset();
+  ioService->run();
+  BOOST_CHECK_EQUAL(failed.size(), 4);
+  BOOST_CHECK(verified.empty());
+}
+
+// runs on a clock the test advances
+class ManualNegativeCertificateCache : public NegativeCertificateCache
+{
+public:
+  ManualNegativeCertificateCache(size_t maxSize = 1000, int initialTtl = 1000, int maxTtl = 60000)
+    : NegativeCertificateCache(maxSize, initialTtl, maxTtl)
+    , m_now(NegativeCertificateCache::getNow())
+  {}
+
+  void
+  advance(int milliseconds)
+  { m_now += boost::posix_time::milliseconds(milliseconds); }
+
+protected:
+  virtual Time
+  getNow()
+  { return m_now; }
+
+private:
+  Time m_now;
+};
+
+class ManualVerifiedChainCache : public VerifiedChainCache
+{
+public:
+  ManualVerifiedChainCache(size_t maxSize = 1000)
+    : VerifiedChainCache(maxSize)
+    , m_now(VerifiedChainCache::getNow())
+  {}
+
+  void
+  advance(int milliseconds)
+  { m_now += milliseconds; }
+
+  virtual MillisecondsSince1970
+  getNow()
+  { return m_now; }
+
+private:
+  MillisecondsSince1970 m_now;
+};
+
+BOOST_FIXTURE_TEST_CASE(NegativeCertificates, DskPolicyFixture)
+{
+  ManualNegativeCertificateCache cache(2, 200, 400);
+  Name key1("/ndn/ucla/KEY/dsk-1/ID-CERT");
+  BOOST_CHECK_EQUAL(cache.find(key1), false);
+  cache.insert(key1);
+  BOOST_CHECK_EQUAL(cache.find(key1), true);
+  BOOST_CHECK_EQUAL(cache.getHitCount(), 1);
+  BOOST_CHECK_EQUAL(cache.getMissCount(), 1);
+
+  cache.advance(199);
+  BOOST_CHECK_EQUAL(cache.find(key1), true);
+  cache.advance(1);
+  BOOST_CHECK_EQUAL(cache.find(key1), false);
+  // failing again backs off to 400ms
+  cache.insert(key1);
+  cache.advance(399);
+  BOOST_CHECK_EQUAL(cache.find(key1), true);
+  cache.advance(1);
+  BOOST_CHECK_EQUAL(cache.find(key1), false);
+  // up to the maximum TTL
+  cache.insert(key1);
+  cache.advance(399);
+  BOOST_CHECK_EQUAL(cache.find(key1), true);
+  // a failure long after the previous one starts again from the initial TTL
+  cache.advance(1000);
+  cache.insert(key1);
+  cache.advance(200);
+  BOOST_CHECK_EQUAL(cache.find(key1), false);
+  cache.insert(key1);
+  cache.erase(key1);
+  BOOST_CHECK_EQUAL(cache.find(key1), false);
+
+  // the least recently failed key locator is evicted
+  cache.insert(Name("/ndn/ucla/KEY/dsk-2/ID-CERT"));
+  cache.insert(Name("/ndn/ucla/KEY/dsk-3/ID-CERT"));
+  cache.insert(Name("/ndn/ucla/KEY/dsk-4/ID-CERT"));
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+  BOOST_CHECK_EQUAL(cache.find(Name("/ndn/ucla/KEY/dsk-2/ID-CERT")), false);
+
+  policy.setNegativeCertificateCache(ptr_lib::make_shared<NegativeCertificateCache>());
+
+  ptr_lib::shared_ptr<ValidationRequest> request =
+    policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%00", key1.toUri()), 0, onVerified, onVerifyFailed);
+  BOOST_REQUIRE(static_cast<bool>(request));
+  request->m_onVerifyFailed(ptr_lib::make_shared<Data>(Name("/ndn/ucla/KEY/dsk-1/ID-CERT/%01")));
+  BOOST_CHECK_EQUAL(failed.size(), 1);
+
+  // rejected without a fetch while the failure is remembered
+  BOOST_CHECK(!static_cast<bool>(policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%01", key1.toUri()),
+                                                                0, onVerified, onVerifyFailed)));
+  BOOST_CHECK_EQUAL(failed.size(), 2);
+}
+
+BOOST_FIXTURE_TEST_CASE(ExpiredFetches, DskPolicyFixture)
+{
+  ptr_lib::shared_ptr<NegativeCertificateCache> negativeCache = ptr_lib::make_shared<NegativeCertificateCache>();
+  policy.setNegativeCertificateCache(negativeCache);
+
+  // a deadline run on the io_service
+  ptr_lib::shared_ptr<boost::asio::io_service> ioService = ptr_lib::make_shared<boost::asio::io_service>();
+  policy.setFetchDeadline(ioService, 10);
+  BOOST_REQUIRE(static_cast<bool>(policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%00", "/ndn/ucla/KEY/dsk-1/ID-CERT"),
+                                                                 0, onVerified, onVerifyFailed)));
+  BOOST_CHECK(!static_cast<bool>(policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%01", "/ndn/ucla/KEY/dsk-1/ID-CERT"),
+                                                                0, onVerified, onVerifyFailed)));
+  ioService->run();
+  BOOST_CHECK_EQUAL(failed.size(), 1);
+  BOOST_CHECK_EQUAL(negativeCache->find(Name("/ndn/ucla/KEY/dsk-1/ID-CERT")), true);
+
+  // rejected without a fetch while the failure is remembered
+  BOOST_CHECK(!static_cast<bool>(policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%02", "/ndn/ucla/KEY/dsk-1/ID-CERT"),
+                                                                0, onVerified, onVerifyFailed)));
+  BOOST_CHECK_EQUAL(failed.size(), 2);
+
+  // a deadline checked when the next packet comes
+  policy.setFetchDeadline(ptr_lib::shared_ptr<boost::asio::io_service>(), 0);
+  BOOST_REQUIRE(static_cast<bool>(policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/b/%00", "/ndn/ucla/KEY/dsk-2/ID-CERT"),
+                                                                 0, onVerified, onVerifyFailed)));
+  BOOST_CHECK(!static_cast<bool>(policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/b/%01", "/ndn/ucla/KEY/dsk-2/ID-CERT"),
+                                                                0, onVerified, onVerifyFailed)));
+  BOOST_CHECK_EQUAL(failed.size(), 3);
+  BOOST_CHECK_EQUAL(negativeCache->find(Name("/ndn/ucla/KEY/dsk-2/ID-CERT")), true);
+}
+
+BOOST_FIXTURE_TEST_CASE(VerifiedChains, DskPolicyFixture)
+{
+  ManualVerifiedChainCache cache(10);
+  MillisecondsSince1970 now = cache.getNow();
+  ptr_lib::shared_ptr<IdentityCertificate> certificate = ptr_lib::make_shared<IdentityCertificate>();
+  certificate->setName(Name("/ndn/ucla/KEY/dsk-1/ID-CERT/%01"));
+  certificate->setNotAfter(now + 100000);
+
+  VerifiedChainCache::Link link;
+  // bounded by the chain of the issuer
+  BOOST_CHECK(cache.insert(certificate, ptr_lib::shared_ptr<const DecodedPublicKey>(), Name("/ndn/KEY/ksk-1/ID-CERT"),
+                           now + 50000) <= now + 50000);
+  BOOST_REQUIRE(cache.find(Name("/ndn/ucla/KEY/dsk-1/ID-CERT"), link));
+  BOOST_CHECK_EQUAL(link.m_anchorName, Name("/ndn/KEY/ksk-1/ID-CERT"));
+  BOOST_CHECK_EQUAL(link.m_certificate->getName(), certificate->getName());
+  // bounded by its own freshness
+  certificate->setFreshnessPeriod(1000);
+  BOOST_CHECK(cache.insert(certificate, ptr_lib::shared_ptr<const DecodedPublicKey>(), Name("/ndn/KEY/ksk-1/ID-CERT"),
+                           now + 50000) == now + 1000);
+  // a chain that has expired is not recorded
+  ptr_lib::shared_ptr<IdentityCertificate> other = ptr_lib::make_shared<IdentityCertificate>();
+  other->setName(Name("/ndn/ucla/KEY/dsk-2/ID-CERT/%01"));
+  cache.insert(other, ptr_lib::shared_ptr<const DecodedPublicKey>(), Name("/ndn/KEY/ksk-1/ID-CERT"), now - 1);
+  BOOST_CHECK_EQUAL(cache.find(Name("/ndn/ucla/KEY/dsk-2/ID-CERT"), link), false);
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+
+  ptr_lib::shared_ptr<IdentityCertificate> anchor = ptr_lib::make_shared<IdentityCertificate>();
+  anchor->setName(Name("/ndn/KEY/ksk-1/ID-CERT/%01"));
+
+  ptr_lib::shared_ptr<ManualVerifiedChainCache> chainCache = ptr_lib::make_shared<ManualVerifiedChainCache>();
+  policy.setVerifiedChainCache(chainCache);
+  policy.addTrustAnchor(anchor);
+  // the certificates of the chain are signed by ksks
+  policy.addVerificationPolicyRule(ptr_lib::make_shared<SecRuleRelative>("^(<>*)<>$", "^([^<KEY>]*)<KEY><>*<ID-CERT>$",
+                                                                         ">", "\\1", "\\1", true));
+
+  ptr_lib::shared_ptr<ValidationRequest> request =
+    policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%00", "/ndn/ucla/KEY/dsk-1/ID-CERT"), 0, onVerified, onVerifyFailed);
+  BOOST_REQUIRE(static_cast<bool>(request));
+
+  // the certificate signed by the anchor has been verified, its chain expires with its freshness
+  ptr_lib::shared_ptr<Data> signCertificate = makeSignedData("/ndn/ucla/KEY/dsk-1/ID-CERT/%01", "/ndn/KEY/ksk-1/ID-CERT");
+  signCertificate->setFreshnessPeriod(300);
+  request->m_onVerified(signCertificate);
+  BOOST_CHECK_EQUAL(failed.size(), 1);
+  BOOST_REQUIRE(chainCache->find(Name("/ndn/ucla/KEY/dsk-1/ID-CERT"), link));
+  BOOST_CHECK_EQUAL(link.m_anchorName, Name("/ndn/KEY/ksk-1/ID-CERT"));
+
+  // no chain step for a packet signed by a certificate of the chain
+  BOOST_CHECK(!static_cast<bool>(policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%01", "/ndn/ucla/KEY/dsk-1/ID-CERT"),
+                                                                0, onVerified, onVerifyFailed)));
+  BOOST_CHECK_EQUAL(failed.size(), 2);
+
+  chainCache->advance(300);
+  BOOST_CHECK(static_cast<bool>(policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%02", "/ndn/ucla/KEY/dsk-1/ID-CERT"),
+                                                               0, onVerified, onVerifyFailed)));
+  BOOST_CHECK(verified.empty());
+}
+
+BOOST_AUTO_TEST_CASE(UncachedIssuerChains)
+{
+  ptr_lib::shared_ptr<IdentityCertificate> anchor = ptr_lib::make_shared<IdentityCertificate>();
+  anchor->setName(Name("/ndn/KEY/ksk-0/ID-CERT/%01"));
+
+  // a chain cache without room, and one whose only entry is evicted
+  for(size_t maxSize = 0; maxSize < 2; maxSize++)
+    {
+      DskPolicyFixture fixture;
+      ptr_lib::shared_ptr<ManualVerifiedChainCache> chainCache = ptr_lib::make_shared<ManualVerifiedChainCache>(maxSize);
+      ptr_lib::shared_ptr<NegativeCertificateCache> negativeCache = ptr_lib::make_shared<NegativeCertificateCache>();
+      fixture.policy.setVerifiedChainCache(chainCache);
+      fixture.policy.setNegativeCertificateCache(negativeCache);
+      fixture.policy.addTrustAnchor(anchor);
+      fixture.policy.addVerificationPolicyRule(ptr_lib::make_shared<SecRuleRelative>("^(<>*)<>$", "^([^<KEY>]*)<KEY><>*<ID-CERT>$",
+                                                                                     ">=", "\\1", "\\1", true));
+
+      for(size_t i = 1; i <= 1 + maxSize; i++)
+        {
+          ostringstream keyName;
+          keyName << "/ndn/ucla/KEY/ksk-" << i << "/ID-CERT";
+          ptr_lib::shared_ptr<ValidationRequest> request =
+            fixture.policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%00", keyName.str()), 0,
+                                                   fixture.onVerified, fixture.onVerifyFailed);
+          BOOST_REQUIRE(static_cast<bool>(request));
+          ptr_lib::shared_ptr<Data> ksk = makeSignedData(keyName.str() + "/%01", "/ndn/KEY/ksk-0/ID-CERT");
+          ksk->setFreshnessPeriod(10000);
+          request->m_onVerified(ksk);
+        }
+      VerifiedChainCache::Link link;
+      BOOST_CHECK_EQUAL(chainCache->find(Name("/ndn/ucla/KEY/ksk-1/ID-CERT"), link), false);
+
+      // the Verifier has verified the dsk with ksk-1, whose chain is not in the cache
+      ptr_lib::shared_ptr<ValidationRequest> request =
+        fixture.policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%01", "/ndn/ucla/KEY/dsk-1/ID-CERT"), 0,
+                                               fixture.onVerified, fixture.onVerifyFailed);
+      BOOST_REQUIRE(static_cast<bool>(request));
+      ptr_lib::shared_ptr<Data> dsk = makeSignedData("/ndn/ucla/KEY/dsk-1/ID-CERT/%01", "/ndn/ucla/KEY/ksk-1/ID-CERT");
+      dsk->setFreshnessPeriod(10000);
+      request->m_onVerified(dsk);
+      BOOST_CHECK_EQUAL(negativeCache->find(Name("/ndn/ucla/KEY/dsk-1/ID-CERT")), false);
+
+      // the dsk is kept in the certificate cache, its next packet needs no chain step
+      size_t failedCount = fixture.failed.size();
+      BOOST_CHECK(!static_cast<bool>(fixture.policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%02", "/ndn/ucla/KEY/dsk-1/ID-CERT"),
+                                                                            0, fixture.onVerified, fixture.onVerifyFailed)));
+      BOOST_CHECK_EQUAL(fixture.failed.size(), failedCount + 1);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(PredictedChains, DskPolicyFixture)
+{
+  ptr_lib::shared_ptr<IdentityCertificate> anchor = ptr_lib::make_shared<IdentityCertificate>();
+  anchor->setName(Name("/ndn/KEY/ksk-0/ID-CERT/%01"));
+
+  ptr_lib::shared_ptr<ManualVerifiedChainCache> chainCache = ptr_lib::make_shared<ManualVerifiedChainCache>();
+  policy.setVerifiedChainCache(chainCache);
+  policy.setPrefetchFace(ptr_lib::make_shared<Face>());
+  policy.addTrustAnchor(anchor);
+  // the certificates of the chain are signed by ksks, the ksk of a prefix by the one above
+  policy.addVerificationPolicyRule(ptr_lib::make_shared<SecRuleRelative>("^(<>*)<>$", "^([^<KEY>]*)<KEY><>*<ID-CERT>$",
+                                                                         ">=", "\\1", "\\1", true));
+
+  // a chain of two certificates below the anchor, fetched one step after the other
+  ptr_lib::shared_ptr<ValidationRequest> dskRequest =
+    policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%00", "/ndn/ucla/KEY/dsk-1/ID-CERT"), 0, onVerified, onVerifyFailed);
+  BOOST_REQUIRE(static_cast<bool>(dskRequest));
+  BOOST_CHECK(policy.predictChain(Name("/ndn/ucla/KEY/dsk-1/ID-CERT")).empty());
+
+  ptr_lib::shared_ptr<Data> dsk = makeSignedData("/ndn/ucla/KEY/dsk-1/ID-CERT/%01", "/ndn/ucla/KEY/ksk-1/ID-CERT");
+  dsk->setFreshnessPeriod(200);
+  ptr_lib::shared_ptr<ValidationRequest> kskRequest =
+    policy.checkVerificationPolicy(dsk, dskRequest->m_stepCount, dskRequest->m_onVerified, dskRequest->m_onVerifyFailed);
+  BOOST_REQUIRE(static_cast<bool>(kskRequest));
+  BOOST_CHECK_EQUAL(kskRequest->m_interest->getName(), Name("/ndn/ucla/KEY/ksk-1/ID-CERT"));
+
+  // verified the way the Verifier reports it
+  ptr_lib::shared_ptr<Data> ksk = makeSignedData("/ndn/ucla/KEY/ksk-1/ID-CERT/%01", "/ndn/KEY/ksk-0/ID-CERT");
+  ksk->setFreshnessPeriod(200);
+  kskRequest->m_onVerified(ksk);
+  dskRequest->m_onVerified(dsk);
+
+  // known certificates are not predicted
+  BOOST_CHECK(policy.predictChain(Name("/ndn/ucla/KEY/dsk-1/ID-CERT")).empty());
+
+  // once the chain has expired, the issuers are predicted up to the anchor
+  chainCache->advance(200);
+  vector<Name> chain = policy.predictChain(Name("/ndn/ucla/KEY/dsk-1/ID-CERT"));
+  BOOST_REQUIRE_EQUAL(chain.size(), 1);
+  BOOST_CHECK_EQUAL(chain[0], Name("/ndn/ucla/KEY/ksk-1/ID-CERT"));
+
+  // a link the rules no longer accept ends the prediction
+  policy.addVerificationPolicyRule(ptr_lib::make_shared<SecRuleRelative>("^(<>*)<KEY><dsk-1><ID-CERT><>$", "^(<>*)<KEY><ksk-1><ID-CERT>$",
+                                                                         "==", "\\1", "\\1", false));
+  BOOST_CHECK(policy.predictChain(Name("/ndn/ucla/KEY/dsk-1/ID-CERT")).empty());
+}
+
+// the prefetch Interests of a policy, kept instead of expressed
+struct PrefetchInterests
+{
+  vector<Name> m_names;
+  vector<OnData> m_onData;
+  vector<OnTimeout> m_onTimeout;
+};
+
+class PrefetchRecordingPolicy : public SecPolicySimple
+{
+public:
+  PrefetchRecordingPolicy(PrefetchInterests* interests)
+    : m_interests(interests)
+  {}
+
+protected:
+  virtual const PendingInterestId*
+  expressPrefetchInterest(const Name& name, const OnData& onData, const OnTimeout& onTimeout)
+  {
+    m_interests->m_names.push_back(name);
+    m_interests->m_onData.push_back(onData);
+    m_interests->m_onTimeout.push_back(onTimeout);
+    return 0;
+  }
+
+private:
+  PrefetchInterests* m_interests;
+};
+
+// the chain /ndn/ucla/KEY/dsk-1 <- /ndn/ucla/KEY/ksk-1 <- the anchor /ndn/KEY/ksk-0 is learned,
+// and expires; the returned ksk is the certificate of ksk-1
+ptr_lib::shared_ptr<Data>
+learnExpiredChain(SecPolicySimple& policy, DskPolicyFixture& fixture)
+{
+  ptr_lib::shared_ptr<IdentityCertificate> anchor = ptr_lib::make_shared<IdentityCertificate>();
+  anchor->setName(Name("/ndn/KEY/ksk-0/ID-CERT/%01"));
+
+  ptr_lib::shared_ptr<ManualVerifiedChainCache> chainCache = ptr_lib::make_shared<ManualVerifiedChainCache>();
+  policy.setVerifiedChainCache(chainCache);
+  policy.setPrefetchFace(ptr_lib::make_shared<Face>());
+  policy.addTrustAnchor(anchor);
+  policy.addVerificationPolicyRule(ptr_lib::make_shared<SecRuleRelative>("^(<>*)<>$", "^([^<KEY>]*)<KEY><>*<ID-CERT>$",
+                                                                         ">=", "\\1", "\\1", true));
+
+  ptr_lib::shared_ptr<ValidationRequest> dskRequest =
+    policy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%00", "/ndn/ucla/KEY/dsk-1/ID-CERT"), 0,
+                                   fixture.onVerified, fixture.onVerifyFailed);
+  ptr_lib::shared_ptr<Data> dsk = makeSignedData("/ndn/ucla/KEY/dsk-1/ID-CERT/%01", "/ndn/ucla/KEY/ksk-1/ID-CERT");
+  dsk->setFreshnessPeriod(200);
+  ptr_lib::shared_ptr<ValidationRequest> kskRequest =
+    policy.checkVerificationPolicy(dsk, dskRequest->m_stepCount, dskRequest->m_onVerified, dskRequest->m_onVerifyFailed);
+  ptr_lib::shared_ptr<Data> ksk = makeSignedData("/ndn/ucla/KEY/ksk-1/ID-CERT/%01", "/ndn/KEY/ksk-0/ID-CERT");
+  ksk->setFreshnessPeriod(200);
+  kskRequest->m_onVerified(ksk);
+  dskRequest->m_onVerified(dsk);
+
+  chainCache->advance(200);
+  return ksk;
+}
+
+BOOST_FIXTURE_TEST_CASE(PrefetchedCertificates, DskPolicyFixture)
+{
+  PrefetchInterests interests;
+  PrefetchRecordingPolicy prefetchPolicy(&interests);
+  ptr_lib::shared_ptr<Data> ksk = learnExpiredChain(prefetchPolicy, *this);
+
+  // the dsk is fetched, and ksk-1 prefetched with it
+  ptr_lib::shared_ptr<Data> data = makeSignedData("/ndn/ucla/a/%01", "/ndn/ucla/KEY/dsk-1/ID-CERT");
+  ptr_lib::shared_ptr<ValidationRequest> request = prefetchPolicy.checkVerificationPolicy(data, 0, onVerified, onVerifyFailed);
+  BOOST_REQUIRE(static_cast<bool>(request));
+  BOOST_REQUIRE_EQUAL(interests.m_names.size(), 1);
+  BOOST_CHECK_EQUAL(interests.m_names[0], Name("/ndn/ucla/KEY/ksk-1/ID-CERT"));
+  interests.m_onData[0](ptr_lib::make_shared<Interest>(interests.m_names[0]), ksk);
+
+  // the step of ksk-1 takes the prefetched certificate instead of fetching it, the chain
+  // ends at the anchor, where the signatures of the test fail
+  ptr_lib::shared_ptr<Data> dsk = makeSignedData("/ndn/ucla/KEY/dsk-1/ID-CERT/%01", "/ndn/ucla/KEY/ksk-1/ID-CERT");
+  BOOST_CHECK(!static_cast<bool>(prefetchPolicy.checkVerificationPolicy(dsk, request->m_stepCount,
+                                                                        request->m_onVerified, request->m_onVerifyFailed)));
+  BOOST_CHECK(failed.end() != find(failed.begin(), failed.end(), data->getName()));
+
+  // a prefetched certificate is used once
+  request = prefetchPolicy.checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%02", "/ndn/ucla/KEY/dsk-1/ID-CERT"),
+                                                   0, onVerified, onVerifyFailed);
+  BOOST_REQUIRE(static_cast<bool>(request));
+  BOOST_CHECK(static_cast<bool>(prefetchPolicy.checkVerificationPolicy(dsk, request->m_stepCount,
+                                                                       request->m_onVerified, request->m_onVerifyFailed)));
+}
+
+BOOST_FIXTURE_TEST_CASE(PrefetchOutlivesPolicy, DskPolicyFixture)
+{
+  PrefetchInterests interests;
+  ptr_lib::shared_ptr<PrefetchRecordingPolicy> prefetchPolicy = ptr_lib::make_shared<PrefetchRecordingPolicy>(&interests);
+  ptr_lib::shared_ptr<Data> ksk = learnExpiredChain(*prefetchPolicy, *this);
+  prefetchPolicy->checkVerificationPolicy(makeSignedData("/ndn/ucla/a/%01", "/ndn/ucla/KEY/dsk-1/ID-CERT"),
+                                          0, onVerified, onVerifyFailed);
+  prefetchPolicy.reset();
+
+  // the Interests answered after the policy is destroyed reach nothing
+  BOOST_REQUIRE_EQUAL(interests.m_names.size(), 1);
+  interests.m_onData[0](ptr_lib::make_shared<Interest>(interests.m_names[0]), ksk);
+  interests.m_onTimeout[0](ptr_lib::make_shared<Interest>(interests.m_names[0]));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -14,9 +14,19 @@
 #include "ndn-cpp-et/regex/regex-repeat-matcher.hpp"
 #include "ndn-cpp-et/regex/regex-backref-matcher.hpp"
 #include "ndn-cpp-et/regex/regex-top-matcher.hpp"
+#include "ndn-cpp-et/regex/regex-native-registry.hpp"
+#include "ndn-cpp-et/regex/regex-program.hpp"
+#include "ndn-cpp-et/regex/regex-literal-matcher.hpp"
+#include "ndn-cpp-et/regex/regex-substring-searcher.hpp"
+#include "ndn-cpp-et/regex/regex-complexity.hpp"
+#include "ndn-cpp-et/regex/regex-subpattern-table.hpp"
+#include "ndn-cpp-et/regex/regex-match-memo.hpp"
+#include "ndn-cpp-et/regex/regex-match-trace.hpp"
+#include "ndn-cpp-et/regex/regex-exception.hpp"
 #include "ndn-cpp-et/regex/regex.hpp"
 
 #include <iostream>
+#include <sstream>
 
 using namespace ndn;
 using namespace std;
@@ -446,4 +456,485 @@ BOOST_AUTO_TEST_CASE (TopMatcherAdvanced)
   BOOST_CHECK_EQUAL(cm->expand(), Name("/ndn/edu/ucla/yingdi/mac/"));
 }
 
+static bool
+rejectAll(const RegexNameView& name)
+{ return false; }
+
+static bool
+acceptAll(const RegexNameView& name)
+{ return true; }
+
+BOOST_AUTO_TEST_CASE (NativeMatcher)
+{
+  RegexNativeRegistry::registerMatcher("^<a><b>", &rejectAll);
+  ptr_lib::shared_ptr<Regex> cm = ptr_lib::make_shared<Regex>("^<a><b>");
+  BOOST_CHECK_EQUAL(cm->isNative(), true);
+  bool res = cm->match(Name("/a/b"));
+  BOOST_CHECK_EQUAL(res, false);
+  BOOST_CHECK_EQUAL(cm->getMatchResult ().size(), 0);
+  RegexNativeRegistry::unregisterMatcher("^<a><b>");
+
+  cm = ptr_lib::make_shared<Regex>("^<a><b>");
+  BOOST_CHECK_EQUAL(cm->isNative(), false);
+  res = cm->match(Name("/a/b"));
+  BOOST_CHECK_EQUAL(res, true);
+
+  RegexNativeRegistry::registerMatcher("^(<a>)<b>", &acceptAll);
+  cm = ptr_lib::make_shared<Regex>("^(<a>)<b>");
+  res = cm->match(Name("/a/b/c"));
+  BOOST_CHECK_EQUAL(res, true);
+  BOOST_CHECK_EQUAL(cm->getMatchResult ().size(), 3);
+  BOOST_CHECK_EQUAL(cm->expand("\\1"), Name("/a"));
+  RegexNativeRegistry::unregisterMatcher("^(<a>)<b>");
+}
+
+// The expressions of test/regex-native-rules.txt, compiled into test/regex-native-matchers.cpp
+// by ndn-regex-codegen when the tests are built.
+static const char* const GENERATED_EXPRS[] = {
+  "^<native><edu><ucla>$",
+  "^<native><>*<KEY><dsk-.*><ID-CERT>$",
+  "^<native>[<a><b>]{2,3}<c>",
+  "^<native>(<>*)<v[0-9]+>$",
+  "^<native><@ver><@seg:0-9>$",
+  "^<native><@contains:mac><>{1,2}$",
+  "^<native><@contains:m.c>[^<KEY>]*$",
+};
+
+BOOST_AUTO_TEST_CASE (GeneratedNativeMatcher)
+{
+  vector<Name> names;
+  names.push_back(Name("/native/edu/ucla"));
+  names.push_back(Name("/native/edu/ucla/yingdi"));
+  names.push_back(Name("/native/edu"));
+  names.push_back(Name("/native/KEY/dsk-123/ID-CERT"));
+  names.push_back(Name("/native/edu/ucla/KEY/dsk-123/ID-CERT"));
+  names.push_back(Name("/native/edu/ucla/KEY/ksk-123/ID-CERT"));
+  names.push_back(Name("/native/edu/ucla/KEY/dsk-123/ID-CERT/%FD%01"));
+  names.push_back(Name("/native/a/b/c"));
+  names.push_back(Name("/native/b/b/a/c/d"));
+  names.push_back(Name("/native/a/c"));
+  names.push_back(Name("/native/a/b/a/b/c"));
+  names.push_back(Name("/native/x/y/v12"));
+  names.push_back(Name("/native/v1"));
+  names.push_back(Name("/native/x/v"));
+  names.push_back(Name("/native/%FD%01/%00%05"));
+  names.push_back(Name("/native/%FD%01/%00%0A"));
+  names.push_back(Name("/native/%00%01/%00%05"));
+  names.push_back(Name("/native/imac/x"));
+  names.push_back(Name("/native/imac/x/y/z"));
+  names.push_back(Name("/native/mic/KEY"));
+  names.push_back(Name("/native/macro/a/b"));
+  names.push_back(Name("/native"));
+  names.push_back(Name("/"));
+
+  for(size_t i = 0; i < sizeof(GENERATED_EXPRS) / sizeof(GENERATED_EXPRS[0]); i++)
+    {
+      string expr = GENERATED_EXPRS[i];
+      RegexNativeMatcher native = RegexNativeRegistry::findMatcher(expr);
+      BOOST_REQUIRE_MESSAGE(0 != native, expr + " is not compiled");
+
+      RegexNativeRegistry::unregisterMatcher(expr);
+      Regex interpreted(expr);
+      RegexNativeRegistry::registerMatcher(expr, native);
+      BOOST_REQUIRE_EQUAL(interpreted.isNative(), false);
+
+      Regex compiled(expr);
+      BOOST_CHECK_EQUAL(compiled.isNative(), true);
+
+      vector<Name>::const_iterator it = names.begin();
+      for(; it != names.end(); it++)
+        {
+          bool expected = interpreted.match(*it);
+          BOOST_CHECK_MESSAGE(native(RegexNameView(*it)) == expected, expr << " on " << *it);
+          BOOST_CHECK_MESSAGE(compiled.match(*it) == expected, expr << " on " << *it);
+          if(expected)
+            BOOST_CHECK_EQUAL(compiled.getMatchResult().size(), interpreted.getMatchResult().size());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE (Program)
+{
+  vector<ptr_lib::shared_ptr<Regex> > matchers;
+  matchers.push_back(ptr_lib::make_shared<Regex>("^<ndn>(<>)<DNS>(<>*)<>", "<ndn>\\1\\2"));
+  matchers.push_back(ptr_lib::make_shared<Regex>("<a>[<b><c>]{2,3}(<>*)<d>$"));
+  matchers.push_back(ptr_lib::make_shared<Regex>("^(<>*)[^<x>](<y>?)"));
+
+  ostringstream os;
+  RegexProgram::write(os, matchers);
+  string program = os.str();
+
+  vector<ptr_lib::shared_ptr<Regex> > loaded = RegexProgram::load(reinterpret_cast<const uint8_t*>(program.c_str()), program.size());
+  BOOST_REQUIRE_EQUAL(loaded.size(), 3);
+  BOOST_CHECK_EQUAL(loaded[0]->getExpr(), matchers[0]->getExpr());
+
+  bool res = loaded[0]->match(Name("/ndn/ucla.edu/DNS/yingdi/mac/ksk-1"));
+  BOOST_CHECK_EQUAL(res, true);
+  BOOST_CHECK_EQUAL(loaded[0]->expand(), Name("/ndn/ucla.edu/yingdi/mac"));
+  BOOST_CHECK_EQUAL(loaded[0]->match(Name("/ndn/ucla/yingdi")), false);
+
+  res = loaded[1]->match(Name("/z/a/b/c/e/d"));
+  BOOST_CHECK_EQUAL(res, true);
+  BOOST_CHECK_EQUAL(loaded[1]->getMatchResult().size(), 6);
+  BOOST_CHECK_EQUAL(loaded[1]->expand("\\1"), Name("/e"));
+  BOOST_CHECK_EQUAL(loaded[1]->match(Name("/a/b/d")), false);
+
+  res = loaded[2]->match(Name("/a/b/y"));
+  BOOST_CHECK_EQUAL(res, true);
+  BOOST_CHECK_EQUAL(loaded[2]->expand("\\1\\2"), Name("/a/b"));
+  matchers[2]->match(Name("/a/b/y"));
+  BOOST_CHECK_EQUAL(matchers[2]->expand("\\1\\2"), Name("/a/b"));
+  BOOST_CHECK_EQUAL(loaded[2]->match(Name("/x")), false);
+
+  program[8] = 2;
+  BOOST_CHECK_THROW(RegexProgram::load(reinterpret_cast<const uint8_t*>(program.c_str()), program.size()), RegexException);
+  BOOST_CHECK_THROW(RegexProgram::load(reinterpret_cast<const uint8_t*>(program.c_str()), 20), RegexException);
+}
+
+// a program of one matcher whose section is a single node, the header of an empty
+// program followed by the count, the strings and the node
+static string
+makeNodeProgram(uint8_t type, const string& expr, const string& fields, uint32_t childCount)
+{
+  ostringstream os;
+  RegexProgram::write(os, vector<ptr_lib::shared_ptr<Regex> >());
+  string program = os.str();
+  program.resize(program.size() - 4);
+
+  ostringstream node;
+  uint32_t header[] = {1, 0, 0};
+  node.write(reinterpret_cast<const char*>(header), sizeof(header));
+  node.put(0);
+  uint32_t nodeCount = 1;
+  node.write(reinterpret_cast<const char*>(&nodeCount), 4);
+  node.put(type);
+  uint32_t exprSize = expr.size();
+  node.write(reinterpret_cast<const char*>(&exprSize), 4);
+  node << expr << fields;
+  node.write(reinterpret_cast<const char*>(&childCount), 4);
+  return program + node.str();
+}
+
+static string
+makeRepeatFields(uint32_t indicator, uint32_t repeatMin, uint32_t repeatMax)
+{
+  uint32_t fields[] = {indicator, repeatMin, repeatMax};
+  return string(reinterpret_cast<const char*>(fields), sizeof(fields));
+}
+
+BOOST_AUTO_TEST_CASE (MalformedProgram)
+{
+  // well formed: an empty pattern list as the root, without back references
+  string program = makeNodeProgram(RegexMatcher::EXPR_PATTERNLIST, "", "", 0) + string(8, '\0');
+  BOOST_CHECK_EQUAL(RegexProgram::load(reinterpret_cast<const uint8_t*>(program.c_str()), program.size()).size(), 1);
+
+  // a count is checked against the remaining bytes before anything is allocated
+  program = makeNodeProgram(RegexMatcher::EXPR_PSEUDO, "", "", 0xfffffff0);
+  BOOST_CHECK_THROW(RegexProgram::load(reinterpret_cast<const uint8_t*>(program.c_str()), program.size()), RegexException);
+
+  // repetitions out of the range the parser produces
+  program = makeNodeProgram(RegexMatcher::EXPR_REPEAT_PATTERN, "<a>*", makeRepeatFields(3, 5, 2), 0);
+  BOOST_CHECK_THROW(RegexProgram::load(reinterpret_cast<const uint8_t*>(program.c_str()), program.size()), RegexException);
+  program = makeNodeProgram(RegexMatcher::EXPR_REPEAT_PATTERN, "<a>*", makeRepeatFields(9, 0, 1), 0);
+  BOOST_CHECK_THROW(RegexProgram::load(reinterpret_cast<const uint8_t*>(program.c_str()), program.size()), RegexException);
+  program = makeNodeProgram(RegexMatcher::EXPR_REPEAT_PATTERN, "<a>*", makeRepeatFields(3, 0, 0x80000000), 0);
+  BOOST_CHECK_THROW(RegexProgram::load(reinterpret_cast<const uint8_t*>(program.c_str()), program.size()), RegexException);
+}
+
+BOOST_AUTO_TEST_CASE (WireName)
+{
+  Name name("/ndn/ucla.edu/%00%01/.../yingdi");
+  Block wire = name.wireEncode();
+
+  ptr_lib::shared_ptr<Regex> cm = ptr_lib::make_shared<Regex>("^<ndn>(<>)<%00%01><\\.\\.\\.\\.\\.\\.>(<>*)$");
+  bool res = cm->match(wire);
+  BOOST_CHECK_EQUAL(res, true);
+  BOOST_CHECK_EQUAL(cm->getMatchResult().size(), 5);
+  BOOST_CHECK_EQUAL(cm->expand("\\1\\2"), Name("/ucla.edu/yingdi"));
+
+  res = cm->match(wire.wire(), wire.size());
+  BOOST_CHECK_EQUAL(res, true);
+  BOOST_CHECK_EQUAL(cm->expand("\\1\\2"), Name("/ucla.edu/yingdi"));
+
+  cm = ptr_lib::make_shared<Regex>("^<ndn><ucla>");
+  BOOST_CHECK_EQUAL(cm->match(wire), false);
+  BOOST_CHECK_EQUAL(cm->match(wire.wire(), wire.size()), false);
+
+  BOOST_CHECK_THROW(cm->match(wire.wire(), wire.size() - 1), RegexException);
+  BOOST_CHECK_THROW(cm->match(wire.wire() + 2, wire.size() - 2), RegexException);
+
+  // the view walks the TLVs of a received Block without parsing it
+  Block received(wire.wire(), wire.size());
+  RegexNameView::ValueList values;
+  RegexNameView view(received, values);
+  BOOST_CHECK_EQUAL(received.elements().size(), 0);
+  BOOST_CHECK_EQUAL(view.size(), 5);
+  BOOST_CHECK_EQUAL(view.toEscapedString(1), "ucla.edu");
+  BOOST_CHECK_EQUAL(view.toEscapedString(3), "......");
+
+  cm = ptr_lib::make_shared<Regex>("^<ndn>(<>)<%00%01><\\.\\.\\.\\.\\.\\.>(<>*)$");
+  BOOST_CHECK_EQUAL(cm->match(view), true);
+  BOOST_CHECK_EQUAL(cm->expand("\\1\\2"), Name("/ucla.edu/yingdi"));
+
+  // the storage is reused by the next view
+  const RegexNameView::ValueList::value_type* storage = &values[0];
+  RegexNameView other(received, values);
+  BOOST_CHECK_EQUAL(&values[0], storage);
+  BOOST_CHECK_EQUAL(other.size(), 5);
+}
+
+BOOST_AUTO_TEST_CASE (LiteralMatcher)
+{
+  ptr_lib::shared_ptr<Regex> cm = Regex::fromName(Name("/ndn/ucla.edu/%00%01"));
+  BOOST_CHECK_EQUAL(cm->getExpr(), "^<ndn><ucla\\.edu><%00%01>");
+  bool res = cm->match(Name("/ndn/ucla.edu/%00%01/yingdi"));
+  BOOST_CHECK_EQUAL(res, true);
+  BOOST_CHECK_EQUAL(cm->getMatchResult().size(), 4);
+  BOOST_CHECK_EQUAL(cm->expand("<a>\\0"), Name("/a/ndn/ucla.edu/%00%01/yingdi"));
+  BOOST_CHECK_EQUAL(cm->match(Name("/ndn/uclaXedu/%00%01")), false);
+  BOOST_CHECK_EQUAL(cm->match(Name("/ndn/ucla.edu")), false);
+  BOOST_CHECK_EQUAL(cm->getMatchResult().size(), 0);
+
+  cm = Regex::fromName(Name("/ndn/ucla.edu"), true);
+  BOOST_CHECK_EQUAL(cm->match(Name("/ndn/ucla.edu")), true);
+  BOOST_CHECK_EQUAL(cm->match(Name("/ndn/ucla.edu/yingdi")), false);
+
+  Block wire = Name("/ndn/ucla.edu").wireEncode();
+  BOOST_CHECK_EQUAL(cm->match(wire.wire(), wire.size()), true);
+
+  Regex compiled(cm->getExpr());
+  BOOST_CHECK_EQUAL(compiled.match(Name("/ndn/ucla.edu")), true);
+  BOOST_CHECK_EQUAL(compiled.match(Name("/ndn/ucla.edu/yingdi")), false);
+
+  // literal components are compared with the component bytes, as their escaped form
+  Regex literal("^<ksk-.*><%00%01><ID-CERT>$");
+  BOOST_CHECK_EQUAL(literal.match(Name("/ksk-123/%00%01/ID-CERT")), true);
+  BOOST_CHECK_EQUAL(literal.match(Name("/ksk-/%00%01/ID-CERT")), true);
+  BOOST_CHECK_EQUAL(literal.match(Name("/ksk/%00%01/ID-CERT")), false);
+  BOOST_CHECK_EQUAL(literal.match(Name("/ksk-1/%00%01%02/ID-CERT")), false);
+  BOOST_CHECK_EQUAL(Regex("^<%0a>$").match(Name("/%0A")), false);
+  BOOST_CHECK_EQUAL(Regex("^<%41>$").match(Name("/A")), false);
+}
+
+BOOST_AUTO_TEST_CASE (SuffixMatcher)
+{
+  ptr_lib::shared_ptr<Regex> cm = ptr_lib::make_shared<Regex>("^([^<KEY>]*)<KEY>(<>*)<ksk-.*><ID-CERT>$");
+  bool res = cm->match(Name("/ndn/ucla.edu/KEY/yingdi/ksk-123/ID-CERT"));
+  BOOST_CHECK_EQUAL(res, true);
+  BOOST_CHECK_EQUAL(cm->expand("\\1\\2"), Name("/ndn/ucla.edu/yingdi"));
+  BOOST_CHECK_EQUAL(cm->match(Name("/ndn/ucla.edu/KEY/yingdi/ksk-123/ID-CERT/v1")), false);
+  BOOST_CHECK_EQUAL(cm->match(Name("/ndn/ucla.edu/KEY/yingdi/dsk-123/ID-CERT")), false);
+  BOOST_CHECK_EQUAL(cm->match(Name("/ID-CERT")), false);
+
+  cm = ptr_lib::make_shared<Regex>("<KEY>(<>{2})$");
+  res = cm->match(Name("/ndn/KEY/a/KEY/b/c"));
+  BOOST_CHECK_EQUAL(res, true);
+  BOOST_CHECK_EQUAL(cm->getMatchResult().size(), 6);
+  BOOST_CHECK_EQUAL(cm->expand("\\1"), Name("/b/c"));
+  BOOST_CHECK_EQUAL(cm->match(Name("/ndn/KEY/a/b/c")), false);
+
+  cm = ptr_lib::make_shared<Regex>("^<ndn>[^<KEY>]{2}$");
+  BOOST_CHECK_EQUAL(cm->match(Name("/ndn/a/b")), true);
+  BOOST_CHECK_EQUAL(cm->match(Name("/ndn/a/KEY")), false);
+  BOOST_CHECK_EQUAL(cm->match(Name("/a/b")), false);
+}
+
+BOOST_AUTO_TEST_CASE (TypedPredicate)
+{
+  ptr_lib::shared_ptr<Regex> cm = ptr_lib::make_shared<Regex>("^<video>(<@ver>)<@seg:0-9>$");
+  bool res = cm->match(Name("/video/%FD%01%02/%00%09"));
+  BOOST_CHECK_EQUAL(res, true);
+  BOOST_CHECK_EQUAL(cm->expand("\\1"), Name("/%FD%01%02"));
+  BOOST_CHECK_EQUAL(cm->match(Name("/video/%FD%01%02/%00")), true);
+  BOOST_CHECK_EQUAL(cm->match(Name("/video/%FD%01%02/%00%0A")), false);
+  BOOST_CHECK_EQUAL(cm->match(Name("/video/%FC%01%02/%00%01")), false);
+  BOOST_CHECK_EQUAL(cm->match(Name("/video/%FD%01%02/%01")), false);
+
+  cm = ptr_lib::make_shared<Regex>("^[<@num:256-512><@ts:-1000>]$");
+  BOOST_CHECK_EQUAL(cm->match(Name("/%01%00")), true);
+  BOOST_CHECK_EQUAL(cm->match(Name("/%FF")), false);
+  BOOST_CHECK_EQUAL(cm->match(Name("/%FC%03%E8")), true);
+  BOOST_CHECK_EQUAL(cm->match(Name("/%FC%03%E9")), false);
+  BOOST_CHECK_EQUAL(cm->match(Name("/%01%02%03%04%05%06%07%08%09")), false);
+
+  cm = ptr_lib::make_shared<Regex>("^<a>[^<@seg>]");
+  BOOST_CHECK_EQUAL(cm->match(Name("/a/%00%01")), false);
+  BOOST_CHECK_EQUAL(cm->match(Name("/a/b")), true);
+
+  BOOST_CHECK_THROW(Regex("^<@segment>"), RegexException);
+  BOOST_CHECK_THROW(Regex("^<@seg:9-1>"), RegexException);
+  BOOST_CHECK_THROW(Regex("^<@num:a-b>"), RegexException);
+  BOOST_CHECK_THROW(Regex("^<@ver:->"), RegexException);
+}
+
+BOOST_AUTO_TEST_CASE (ComponentSearch)
+{
+  ptr_lib::shared_ptr<Regex> cm = ptr_lib::make_shared<Regex>("^<app><@contains:tenant-42>");
+  bool res = cm->match(Name("/app/session.0123456789abcdef.tenant-42.0123456789abcdef/data"));
+  BOOST_CHECK_EQUAL(res, true);
+  BOOST_CHECK_EQUAL(cm->match(Name("/app/tenant-42")), true);
+  BOOST_CHECK_EQUAL(cm->match(Name("/app/session.0123456789abcdef.tenant-4.0123456789abcdef")), false);
+  BOOST_CHECK_EQUAL(cm->match(Name("/app/tenant")), false);
+
+  cm = ptr_lib::make_shared<Regex>("^<app><@contains:%00%FF>");
+  BOOST_CHECK_EQUAL(cm->match(Name("/app/abcdefghijklmnopqrstuvwxyz%00%FF")), true);
+  BOOST_CHECK_EQUAL(cm->match(Name("/app/abcdefghijklmnopqrstuvwxyz%00%FE")), false);
+
+  cm = ptr_lib::make_shared<Regex>("^<app>(<@contains:tenant-[0-9]+>)<>*");
+  res = cm->match(Name("/app/x.tenant-7.y/data"));
+  BOOST_CHECK_EQUAL(res, true);
+  BOOST_CHECK_EQUAL(cm->expand("\\1"), Name("/x.tenant-7.y"));
+  BOOST_CHECK_EQUAL(cm->match(Name("/app/x.tenant-.y/data")), false);
+
+  RegexSubstringSearcher searcher("abcab");
+  string haystack = "abcaXabcaabcabXXXXXXXXXXXXXXXXXXXXXXabcab";
+  const uint8_t* begin = reinterpret_cast<const uint8_t*>(haystack.c_str());
+  BOOST_CHECK_EQUAL(searcher.find(begin, haystack.size()) - begin, 9);
+  BOOST_CHECK_EQUAL(searcher.find(begin + 10, haystack.size() - 10) - begin, 36);
+  BOOST_CHECK(0 == searcher.find(begin + 37, haystack.size() - 37));
+}
+
+BOOST_AUTO_TEST_CASE (Complexity)
+{
+  RegexComplexity literal(*Regex::fromName(Name("/ndn/ucla.edu")));
+  BOOST_CHECK_EQUAL(literal.getDegree(), 1);
+  BOOST_CHECK_EQUAL(literal.isExponential(), false);
+
+  RegexComplexity rule(Regex("^([^<KEY>]*)<KEY>(<>*)<ksk-.*><ID-CERT>$"));
+  BOOST_CHECK_EQUAL(rule.isExponential(), false);
+  BOOST_CHECK_EQUAL(rule.isAmbiguous(), false);
+  BOOST_CHECK_EQUAL(rule.getProblems().size(), 0);
+  BOOST_CHECK_EQUAL(rule.getDegree(), 5);
+
+  RegexComplexity nested(Regex("(<>*<a>*)*"));
+  BOOST_CHECK_EQUAL(nested.isExponential(), true);
+  BOOST_CHECK_EQUAL(nested.isAmbiguous(), true);
+  BOOST_CHECK_EQUAL(nested.getProblems().size(), 1);
+  BOOST_CHECK(nested.getCost(40) > rule.getCost(40));
+
+  RegexComplexity bounded(Regex("^(<a><b>?){2}$"));
+  BOOST_CHECK_EQUAL(bounded.isExponential(), false);
+  BOOST_CHECK_EQUAL(bounded.isAmbiguous(), true);
+  BOOST_CHECK_EQUAL(bounded.getDegree(), 5);
+}
+
+BOOST_AUTO_TEST_CASE (SharedSubpattern)
+{
+  Regex rule1("^([^<KEY>]*)<KEY>(<>*)<ksk-.*><ID-CERT>$");
+  Regex rule2("^([^<KEY>]*)<KEY><>*<ID-CERT>$");
+  Regex rule3("^<ndn>(<a(b)>)<KEY>");
+
+  const vector<ptr_lib::shared_ptr<RegexMatcher> >& list1 = rule1.getPrimaryMatcher()->getMatcherList();
+  const vector<ptr_lib::shared_ptr<RegexMatcher> >& list2 = rule2.getPrimaryMatcher()->getMatcherList();
+  BOOST_CHECK_EQUAL(list1[1], list2[1]);
+  BOOST_CHECK_EQUAL(list1[1]->isShared(), true);
+  BOOST_CHECK_EQUAL(list1[4], list2[3]);
+  BOOST_CHECK_EQUAL(list1[0]->isShared(), false);
+  BOOST_CHECK(RegexSubpatternTable::size() >= 5);
+
+  // a component with marked sub-expressions is not shared
+  const vector<ptr_lib::shared_ptr<RegexMatcher> >& list3 = rule3.getPrimaryMatcher()->getMatcherList();
+  BOOST_CHECK_EQUAL(list3[1]->getMatcherList()[0]->getMatcherList()[0]->isShared(), false);
+  BOOST_CHECK_EQUAL(list3[2], list1[1]);
+
+  Name name("/ndn/edu/ucla/KEY/yingdi/ksk-123/ID-CERT");
+  RegexNameView view(name);
+  RegexMatchMemo memo(view.size());
+  view.setMemo(&memo);
+
+  BOOST_CHECK_EQUAL(rule1.match(view), true);
+  BOOST_CHECK_EQUAL(rule1.expand("\\1\\2"), Name("/ndn/edu/ucla/yingdi"));
+  size_t hitCount = memo.getHitCount();
+  BOOST_CHECK_EQUAL(rule2.match(view), true);
+  BOOST_CHECK(memo.getHitCount() > hitCount);
+  BOOST_CHECK_EQUAL(rule2.expand("\\1"), Name("/ndn/edu/ucla"));
+  BOOST_CHECK_EQUAL(rule1.match(view), true);
+  BOOST_CHECK_EQUAL(rule1.expand("\\1\\2"), Name("/ndn/edu/ucla/yingdi"));
+  BOOST_CHECK_EQUAL(rule2.match(Name("/ndn/KEY/dsk-1/ID-CERT")), true);
+
+  // every shared sub-pattern has its own memo id
+  BOOST_CHECK_EQUAL(list1[0]->getMemoId(), RegexMatcher::NO_MEMO_ID);
+  BOOST_CHECK(list1[1]->getMemoId() < RegexSubpatternTable::getMemoIdCount());
+  BOOST_CHECK(list1[4]->getMemoId() < RegexSubpatternTable::getMemoIdCount());
+  BOOST_CHECK(list1[1]->getMemoId() != list1[4]->getMemoId());
+
+  // the memo moves to another name
+  Name other("/ndn/KEY/ksk-1/ID-CERT");
+  RegexNameView otherView(other);
+  memo.reset(otherView.size());
+  otherView.setMemo(&memo);
+  BOOST_CHECK_EQUAL(memo.getHitCount(), 0);
+  BOOST_CHECK_EQUAL(rule1.match(otherView), true);
+  BOOST_CHECK_EQUAL(rule1.expand("\\1\\2"), Name("/ndn"));
+  BOOST_CHECK_EQUAL(rule2.match(otherView), true);
+  BOOST_CHECK(memo.getHitCount() > 0);
+}
+
+BOOST_AUTO_TEST_CASE (MatchTrace)
+{
+  Regex regex("^(<>*)<b><c>$");
+  RegexMatchTrace trace;
+  bool res = regex.match(Name("/a/a/b/c"), trace);
+  BOOST_CHECK_EQUAL(res, true);
+  BOOST_CHECK_EQUAL(regex.expand("\\1"), Name("/a/a"));
+  BOOST_CHECK_EQUAL(trace.getExpr(), string("^(<>*)<b><c>$"));
+  BOOST_CHECK_EQUAL(trace.isMatched(), true);
+
+  size_t invocations = trace.getInvocations();
+  if(RegexMatchTrace::isEnabled())
+    {
+      BOOST_CHECK(invocations > 1);
+      BOOST_CHECK(trace.getBacktracks() > 0);
+      BOOST_CHECK(trace.getEvaluations() > 0);
+      BOOST_CHECK(trace.getMaxDepth() > 1);
+      BOOST_CHECK(trace.getCounters().size() > 1);
+
+      ostringstream os;
+      os << trace;
+      BOOST_CHECK_EQUAL(os.str().find("^(<>*)<b><c>$ matched: "), 0);
+    }
+  else
+    {
+      BOOST_CHECK_EQUAL(invocations, 0);
+      BOOST_CHECK_EQUAL(trace.getCounters().size(), 0);
+    }
+
+  // only the traced match is counted
+  BOOST_CHECK_EQUAL(regex.match(Name("/a/b/c/c")), false);
+  BOOST_CHECK_EQUAL(trace.getInvocations(), invocations);
+
+  BOOST_CHECK_EQUAL(regex.match(Name("/b/c/c"), trace), false);
+  BOOST_CHECK_EQUAL(trace.isMatched(), false);
+}
+
+BOOST_AUTO_TEST_CASE (ExpandInPlace)
+{
+  Regex regex("^(<>*)<KEY>(<>)<ID-CERT>$");
+  Name name("/ndn/ucla/KEY/ksk-1/ID-CERT");
+  RegexNameView view(name);
+  BOOST_CHECK_EQUAL(regex.match(view), true);
+
+  RegexExpandPattern pattern("<x>\\2\\1");
+  RegexExpandPattern::ValueList values;
+  regex.expand(pattern, view, values);
+  BOOST_REQUIRE_EQUAL(values.size(), 4);
+  BOOST_CHECK_EQUAL(string(reinterpret_cast<const char*>(values[0].first), values[0].second), "x");
+  // back references point into the matched name
+  BOOST_CHECK(values[1].first == name.get(3).value());
+  BOOST_CHECK(values[2].first == name.get(0).value());
+  BOOST_CHECK(values[3].first == name.get(1).value());
+  BOOST_CHECK_EQUAL(regex.expand("<x>\\2\\1"), Name("/x/ksk-1/ndn/ucla"));
+
+  // a back reference the match does not go through is empty
+  Regex repeat("^(<a>)*(<b>*)$");
+  BOOST_CHECK_EQUAL(repeat.match(Name("/a/b")), true);
+  BOOST_CHECK_EQUAL(repeat.expand("\\1"), Name("/a"));
+  BOOST_CHECK_EQUAL(repeat.match(Name("/b")), true);
+  BOOST_CHECK_EQUAL(repeat.expand("\\1"), Name());
+
+  BOOST_CHECK_THROW(RegexExpandPattern("\\"), RegexException);
+  BOOST_CHECK_THROW(RegexExpandPattern("<a"), RegexException);
+  BOOST_CHECK_THROW(regex.expand(RegexExpandPattern("\\3"), view, values), RegexException);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil -*- */
+/**
+ * Copyright (C) 2013 Regents of the University of California.
+ * @author: Yingdi Yu <yingdi@cs.ucla.edu>
+ * See COPYING for copyright and distribution information.
+ */
+
+/**
+ * ndn-regex-codegen reads the regular expressions of a policy's rule set and generates a
+ * C++ translation unit with native matchers for them.  Linking the generated file into an
+ * application registers the matchers in RegexNativeRegistry, where RegexTopMatcher (and
+ * therefore SecRuleRelative and SecPolicySimple) picks them up.
+ *
+ * Rule file format, one entry per line, fields separated by white space:
+ *
+ *   rule <data-regex> <signer-regex> [op data-expand signer-expand positive|negative]
+ *   exempt <regex>
+ *   inference <regex>
+ *
+ * Empty lines and lines starting with '#' are ignored.
+ */
+
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+#include "ndn-cpp-et/regex/regex-code-generator.hpp"
+#include "ndn-cpp-et/regex/regex-exception.hpp"
+
+using namespace ndn;
+using namespace std;
+
+static void
+usage(const char* program)
+{
+  cerr << "Usage: " << program << " <rule-file> [output-file]" << endl;
+}
+
+int
+main(int argc, char** argv)
+{
+  if(argc < 2 || argc > 3)
+    {
+      usage(argv[0]);
+      return 1;
+    }
+
+  ifstream input(argv[1]);
+  if(!input.is_open())
+    {
+      cerr << "ERROR: cannot open " << argv[1] << endl;
+      return 1;
+    }
+
+  vector<string> exprs;
+  string line;
+  int lineNo = 0;
+  while(getline(input, line))
+    {
+      lineNo++;
+      istringstream is(line);
+      string keyword;
+      if(!(is >> keyword) || '#' == keyword[0])
+        continue;
+
+      int count = 0;
+      if("rule" == keyword)
+        count = 2;
+      else if("exempt" == keyword || "inference" == keyword)
+        count = 1;
+      else
+        {
+          cerr << "ERROR: " << argv[1] << ":" << lineNo << ": unknown entry " << keyword << endl;
+          return 1;
+        }
+
+      for(int i = 0; i < count; i++)
+        {
+          string expr;
+          if(!(is >> expr))
+            {
+              cerr << "ERROR: " << argv[1] << ":" << lineNo << ": missing regex" << endl;
+              return 1;
+            }
+          exprs.push_back(expr);
+        }
+    }
+
+  RegexCodeGenerator generator;
+  set<string> added;
+  vector<string>::const_iterator it = exprs.begin();
+  for(; it != exprs.end(); it++)
+    {
+      if(!added.insert(*it).second)
+        continue;
+
+      try{
+        if(!generator.addExpression(*it))
+          cerr << "WARNING: " << *it << " is not supported, it will be interpreted" << endl;
+      }catch(RegexException& e){
+        cerr << "ERROR: " << *it << ": " << e.what() << endl;
+        return 1;
+      }
+    }
+
+  if(3 == argc)
+    {
+      ofstream output(argv[2]);
+      if(!output.is_open())
+        {
+          cerr << "ERROR: cannot open " << argv[2] << endl;
+          return 1;
+        }
+      generator.generate(output);
+    }
+  else
+    generator.generate(cout);
+
+  return 0;
+}